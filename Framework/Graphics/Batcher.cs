@@ -26,7 +26,7 @@ public class Batcher : IDisposable
 		public Vector2 Pos = position;
 		public Vector2 Tex = texcoord;
 		public Color Col = color;
-		public Color Mode = mode;  // R = Multiply, G = Wash, B = Fill, A = Padding
+		public Color Mode = mode;  // R = Multiply, G = Wash, B = Fill, A = Distance Field
 
 		public readonly VertexFormat Format => VertexFormat;
 	}
@@ -126,11 +126,20 @@ public class Batcher : IDisposable
 	}
 
 	public Batcher()
+	{
+		defaultMaterialState = new(new Material(GetDefaultShader()), "u_matrix", "u_texture", "u_texture_sampler");
+		Clear();
+	}
+
+	/// <summary>
+	/// Gets the shared default Batcher Shader, creating it if needed.
+	/// Other renderers that use the Batcher Vertex layout (such as the TileMap) share it.
+	/// </summary>
+	internal static Shader GetDefaultShader()
 	{
 		if (DefaultShader == null || DefaultShader.IsDisposed)
 			DefaultShader = new Shader(ShaderDefaults.Batcher[Graphics.Renderer]);
-		defaultMaterialState = new(new Material(DefaultShader), "u_matrix", "u_texture", "u_texture_sampler");
-		Clear();
+		return DefaultShader;
 	}
 
 	~Batcher()
@@ -597,6 +606,16 @@ public class Batcher : IDisposable
 		mode = new Color(0, 0, 255, 0);
 	}
 
+	/// <summary>
+	/// Pushes the Distance Field drawing mode, where the texture alpha is a signed distance field with its edge at 0.5,
+	/// and the vertex color is drawn inside of the edge. This mode is used for drawing Distance Field SpriteFonts.
+	/// </summary>
+	public void PushModeDistanceField()
+	{
+		modeStack.Push(mode);
+		mode = new Color(0, 0, 0, 255);
+	}
+
 	/// <summary>
 	/// Pushes a custom Mode value
 	/// </summary>
@@ -783,6 +802,44 @@ public class Batcher : IDisposable
 		vertexCount += 4;
 	}
 
+	/// <summary>
+	/// Reserves vertex memory for the given number of quads in the current batch, to be filled in directly.
+	/// Each quad is 4 vertices in the same order as <see cref="Quad(in Vector2, in Vector2, in Vector2, in Vector2, in Color)"/>.
+	/// The Batcher Matrix is not applied and texture coordinates are not flipped for Target textures.
+	/// The returned memory is only valid until the next call that adds to this Batcher.
+	/// </summary>
+	public Span<Vertex> ReserveQuads(int count)
+	{
+		if (count <= 0)
+			return Span<Vertex>.Empty;
+
+		EnsureIndexCapacity(indexCount + count * 6);
+		EnsureVertexCapacity(vertexCount + count * 4);
+
+		unsafe
+		{
+			var indexArray = new Span<int>((int*)indexPtr + indexCount, count * 6);
+			for (int i = 0, n = 0, v = vertexCount; i < count; i++, n += 6, v += 4)
+			{
+				indexArray[n + 0] = v + 0;
+				indexArray[n + 1] = v + 1;
+				indexArray[n + 2] = v + 2;
+				indexArray[n + 3] = v + 0;
+				indexArray[n + 4] = v + 2;
+				indexArray[n + 5] = v + 3;
+			}
+
+			var vertexArray = new Span<Vertex>((Vertex*)vertexPtr + vertexCount, count * 4);
+
+			indexCount += count * 6;
+			vertexCount += count * 4;
+			currentBatch.Elements += count * 2;
+			dirty = true;
+
+			return vertexArray;
+		}
+	}
+
 	public void QuadLine(in Vector2 a, in Vector2 b, in Vector2 c, in Vector2 d, float thickness, in Color color)
 	{
 		Line(a, b, thickness, color);
@@ -1127,32 +1184,27 @@ public class Batcher : IDisposable
 				vertexCount += 12;
 			}
 
-			var left = Calc.PI;
-			var right = 0.0f;
-			var up = -Calc.PI / 2;
-			var down = Calc.PI / 2;
-
 			// top-left corner
 			if (r0 > 0)
-				SemiCircle(r0_br, up, -left, r0, Math.Max(3, (int)(r0 / 4)), color);
+				Fan(CornerMatrix(r0_br, r0, 2), GetQuarterTable(CornerSteps(r0)), color, color);
 			else
 				Quad(r0_tl, r0_tr, r0_br, r0_bl, color);
 
 			// top-right corner
 			if (r1 > 0)
-				SemiCircle(r1_bl, up, right, r1, Math.Max(3, (int)(r1 / 4)), color);
+				Fan(CornerMatrix(r1_bl, r1, 3), GetQuarterTable(CornerSteps(r1)), color, color);
 			else
 				Quad(r1_tl, r1_tr, r1_br, r1_bl, color);
 
 			// bottom-right corner
 			if (r2 > 0)
-				SemiCircle(r2_tl, right, down, r2, Math.Max(3, (int)(r2 / 4)), color);
+				Fan(CornerMatrix(r2_tl, r2, 0), GetQuarterTable(CornerSteps(r2)), color, color);
 			else
 				Quad(r2_tl, r2_tr, r2_br, r2_bl, color);
 
 			// bottom-left corner
 			if (r3 > 0)
-				SemiCircle(r3_tr, down, left, r3, Math.Max(3, (int)(r3 / 4)), color);
+				Fan(CornerMatrix(r3_tr, r3, 1), GetQuarterTable(CornerSteps(r3)), color, color);
 			else
 				Quad(r3_tl, r3_tr, r3_br, r3_bl, color);
 		}
@@ -1178,16 +1230,11 @@ public class Batcher : IDisposable
 		}
 		else
 		{
-			var rtlSteps = Math.Max(3, (int)(rtl / 4));
-			var rtrSteps = Math.Max(3, (int)(rtr / 4));
-			var rbrSteps = Math.Max(3, (int)(rbr / 4));
-			var rblSteps = Math.Max(3, (int)(rbl / 4));
-
 			// rounded corners
-			SemiCircleLine(new Vector2(r.X + rtl, r.Y + rtl), Calc.Up, Calc.Left, rtl, rtlSteps, t, color);
-			SemiCircleLine(new Vector2(r.X + r.Width - rtr, r.Y + rtr), Calc.Up, Calc.Up + Calc.TAU * 0.25f, rtr, rtrSteps, t, color);
-			SemiCircleLine(new Vector2(r.X + rbl, r.Y + r.Height - rbl), Calc.Down, Calc.Left, rbl, rblSteps, t, color);
-			SemiCircleLine(new Vector2(r.X + r.Width - rbr, r.Y + r.Height - rbr), Calc.Down, Calc.Right, rbr, rbrSteps, t, color);
+			CornerLine(new Vector2(r.X + rtl, r.Y + rtl), rtl, 2, t, color);
+			CornerLine(new Vector2(r.X + r.Width - rtr, r.Y + rtr), rtr, 3, t, color);
+			CornerLine(new Vector2(r.X + rbl, r.Y + r.Height - rbl), rbl, 1, t, color);
+			CornerLine(new Vector2(r.X + r.Width - rbr, r.Y + r.Height - rbr), rbr, 0, t, color);
 
 			// connect sides that aren't touching
 			if (r.Height > rtl + rbl)
@@ -1212,14 +1259,12 @@ public class Batcher : IDisposable
 
 	public void SemiCircle(in Vector2 center, float startRadians, float endRadians, float radius, int steps, in Color centerColor, in Color edgeColor)
 	{
-		var last = Calc.AngleToVector(startRadians, radius);
+		if (steps <= 0)
+			return;
 
-		for (int i = 1; i <= steps; i++)
-		{
-			var next = Calc.AngleToVector(startRadians + (endRadians - startRadians) * (i / (float)steps), radius);
-			Triangle(center + last, center + next, center, edgeColor, edgeColor, centerColor);
-			last = next;
-		}
+		Span<Vector2> arc = steps < 256 ? stackalloc Vector2[steps + 1] : new Vector2[steps + 1];
+		BuildArc(arc, startRadians, endRadians - startRadians);
+		Fan(ShapeMatrix(center, radius), arc, centerColor, edgeColor);
 	}
 
 	public void SemiCircleLine(in Vector2 center, float startRadians, float endRadians, float radius, int steps, float t, Color color)
@@ -1228,22 +1273,11 @@ public class Batcher : IDisposable
 		{
 			SemiCircle(center, startRadians, endRadians, radius, steps, color, color);
 		}
-		else
+		else if (steps > 0)
 		{
-			var add = Calc.AngleDiff(startRadians, endRadians);
-			var lastInner = Calc.AngleToVector(startRadians, radius - t);
-			var lastOuter = Calc.AngleToVector(startRadians, radius);
-
-			for (int i = 1; i <= steps; i++)
-			{
-				var nextInner = Calc.AngleToVector(startRadians + add * (i / (float)steps), radius - t);
-				var nextOuter = Calc.AngleToVector(startRadians + add * (i / (float)steps), radius);
-
-				Quad(center + lastInner, center + lastOuter, center + nextOuter, center + nextInner, color);
-
-				lastInner = nextInner;
-				lastOuter = nextOuter;
-			}
+			Span<Vector2> arc = steps < 256 ? stackalloc Vector2[steps + 1] : new Vector2[steps + 1];
+			BuildArc(arc, startRadians, Calc.AngleDiff(startRadians, endRadians));
+			Ring(ShapeMatrix(center, radius - t), ShapeMatrix(center, radius), arc, color);
 		}
 	}
 
@@ -1252,14 +1286,10 @@ public class Batcher : IDisposable
 
 	public void Circle(in Vector2 center, float radius, int steps, in Color centerColor, in Color edgeColor)
 	{
-		var last = Calc.AngleToVector(0, radius);
+		if (steps <= 0)
+			return;
 
-		for (int i = 1; i <= steps; i++)
-		{
-			var next = Calc.AngleToVector((i / (float)steps) * Calc.TAU, radius);
-			Triangle(center + last, center + next, center, edgeColor, edgeColor, centerColor);
-			last = next;
-		}
+		Fan(ShapeMatrix(center, radius), GetCircleTable(steps), centerColor, edgeColor);
 	}
 
 	public void Circle(in Circle circle, int steps, in Color color)
@@ -1274,16 +1304,10 @@ public class Batcher : IDisposable
 			return;
 		}
 
-		var last = Calc.AngleToVector(0);
-		for (int i = 1; i <= steps; i++)
-		{
-			var next = Calc.AngleToVector((i / (float)steps) * Calc.TAU);
-			Quad(
-				center + last * innerRadius, center + last * radius,
-				center + next * radius, center + next * innerRadius,
-				color);
-			last = next;
-		}
+		if (steps <= 0)
+			return;
+
+		Ring(ShapeMatrix(center, innerRadius), ShapeMatrix(center, radius), GetCircleTable(steps), color);
 	}
 
 	public void CircleLine(in Circle circle, float thickness, int steps, in Color color)
@@ -1291,15 +1315,16 @@ public class Batcher : IDisposable
 
 	public void CircleDashed(in Vector2 center, float radius, float thickness, int steps, in Color color, float dashLength, float dashOffset)
 	{
-		var last = Calc.AngleToVector(0, radius);
-		var segmentLength = (last - Calc.AngleToVector(Calc.TAU / steps, radius)).Length();
+		if (steps <= 0)
+			return;
+
+		var table = GetCircleTable(steps);
+		var segmentLength = (table[0] - table[1]).Length() * radius;
 
 		for (int i = 1; i <= steps; i++)
 		{
-			var next = Calc.AngleToVector((i / (float)steps) * Calc.TAU, radius);
-			LineDashed(center + last, center + next, thickness, color, dashLength, dashOffset);
+			LineDashed(center + table[i - 1] * radius, center + table[i] * radius, thickness, color, dashLength, dashOffset);
 			dashOffset += segmentLength;
-			last = next;
 		}
 	}
 
@@ -1328,13 +1353,16 @@ public class Batcher : IDisposable
 		}
 		else
 		{
+			var table = GetCircleTable(segments);
+
 			for (int i = 0; i < segments; i++)
 			{
 				float prev = (i / (float)segments);
 				float next = MathF.Min(percent, ((i + 1) / (float)segments));
 
-				Vector2 prev_angle = Calc.AngleToVector(prev * Calc.TAU);
-				Vector2 next_angle = Calc.AngleToVector(next * Calc.TAU);
+				// only the final, partially filled segment lands between table entries
+				Vector2 prev_angle = table[i];
+				Vector2 next_angle = next < (i + 1) / (float)segments ? Calc.AngleToVector(next * Calc.TAU) : table[i + 1];
 
 				Vector2 prev_inner = prev_angle * inner_radius;
 				Vector2 prev_outer = prev_angle * outer_radius;
@@ -1655,6 +1683,20 @@ public class Batcher : IDisposable
 	}
 
 	public void Text(SpriteFont font, ReadOnlySpan<char> text, Vector2 position, Vector2 justify, Color color)
+	{
+		if (font.IsDistanceField)
+		{
+			PushTextDistanceField();
+			TextGlyphs(font, text, position, justify, color);
+			PopTextDistanceField();
+		}
+		else
+		{
+			TextGlyphs(font, text, position, justify, color);
+		}
+	}
+
+	private void TextGlyphs(SpriteFont font, ReadOnlySpan<char> text, Vector2 position, Vector2 justify, Color color)
 	{
 		// TODO:
 		// I feel like the vertical alignment is slightly off, but not sure how.
@@ -1698,6 +1740,38 @@ public class Batcher : IDisposable
 		}
 	}
 
+	/// <summary>
+	/// Draws a previously built TextLayout at the given position
+	/// </summary>
+	public void Text(TextLayout layout, Vector2 position, Color color)
+	{
+		var at = new Vector2(Calc.Round(position.X), Calc.Round(position.Y));
+
+		var distanceField = layout.Font?.IsDistanceField ?? false;
+		if (distanceField)
+			PushTextDistanceField();
+
+		layout.Refresh();
+		foreach (var glyph in layout.Glyphs)
+			Image(glyph.Subtexture, at + glyph.Position, color);
+
+		if (distanceField)
+			PopTextDistanceField();
+	}
+
+	private void PushTextDistanceField()
+	{
+		// distance fields must be sampled linearly for the edge to be smooth
+		PushModeDistanceField();
+		PushSampler(new(TextureFilter.Linear, TextureWrap.ClampToEdge, TextureWrap.ClampToEdge));
+	}
+
+	private void PopTextDistanceField()
+	{
+		PopSampler();
+		PopMode();
+	}
+
 	#endregion
 
 	#region Misc.
@@ -1730,6 +1804,196 @@ public class Batcher : IDisposable
 
 	#endregion
 
+	#region Tessellation Cache
+
+	/// <summary>
+	/// Step counts up to this value have their unit-circle tables cached.
+	/// Larger step counts are still supported, but are built on every call.
+	/// </summary>
+	private const int MaxCachedSteps = 256;
+
+	/// <summary>
+	/// Cached unit-circle points for a full revolution, indexed by step count.
+	/// Each table has (steps + 1) entries, with the last equal to the first.
+	/// </summary>
+	private static readonly Vector2[]?[] circleTables = new Vector2[MaxCachedSteps + 1][];
+
+	/// <summary>
+	/// Cached unit-circle points for a quarter revolution (0 to PI/2), indexed by step count.
+	/// Used for rounded rectangle corners, which are rotated into place by multiples of 90 degrees.
+	/// </summary>
+	private static readonly Vector2[]?[] quarterTables = new Vector2[MaxCachedSteps + 1][];
+
+	private static Vector2[] GetCircleTable(int steps)
+	{
+		// Tables are immutable once built, so racing threads at worst build the same table twice
+		if (steps <= MaxCachedSteps && circleTables[steps] is Vector2[] cached)
+			return cached;
+
+		var table = new Vector2[steps + 1];
+		for (int i = 0; i < steps; i++)
+			table[i] = Calc.AngleToVector((i / (float)steps) * Calc.TAU);
+		table[steps] = table[0];
+
+		if (steps <= MaxCachedSteps)
+			circleTables[steps] = table;
+		return table;
+	}
+
+	private static Vector2[] GetQuarterTable(int steps)
+	{
+		if (steps <= MaxCachedSteps && quarterTables[steps] is Vector2[] cached)
+			return cached;
+
+		var table = new Vector2[steps + 1];
+		for (int i = 0; i < steps; i++)
+			table[i] = Calc.AngleToVector((i / (float)steps) * Calc.HalfPI);
+		table[steps] = Vector2.UnitY;
+
+		if (steps <= MaxCachedSteps)
+			quarterTables[steps] = table;
+		return table;
+	}
+
+	/// <summary>
+	/// Fills the given span with (span.Length - 1) steps of a unit arc.
+	/// Only the start and step angles are evaluated; each following point is rotated from the last.
+	/// </summary>
+	private static void BuildArc(Span<Vector2> points, float startRadians, float sweepRadians)
+	{
+		var steps = points.Length - 1;
+		var (sin, cos) = MathF.SinCos(sweepRadians / steps);
+		var p = Calc.AngleToVector(startRadians);
+
+		for (int i = 0; i < steps; i++)
+		{
+			points[i] = p;
+			p = new Vector2(p.X * cos - p.Y * sin, p.X * sin + p.Y * cos);
+		}
+
+		points[steps] = Calc.AngleToVector(startRadians + sweepRadians);
+	}
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static int CornerSteps(float radius)
+		=> Math.Max(3, (int)(radius / 4));
+
+	/// <summary>
+	/// Transforms unit points to the given circle, and then by the current Batcher Matrix
+	/// </summary>
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private Matrix3x2 ShapeMatrix(in Vector2 center, float radius)
+		=> new Matrix3x2(radius, 0, 0, radius, center.X, center.Y) * Matrix;
+
+	/// <summary>
+	/// Same as ShapeMatrix, but also rotates the points by (quadrant * 90) degrees.
+	/// Used to place the cached quarter table into any corner without evaluating sin/cos.
+	/// </summary>
+	private Matrix3x2 CornerMatrix(in Vector2 center, float radius, int quadrant)
+	{
+		var (c, s) = (quadrant & 3) switch
+		{
+			0 => (1, 0),
+			1 => (0, 1),
+			2 => (-1, 0),
+			_ => (0, -1),
+		};
+
+		return new Matrix3x2(c * radius, s * radius, -s * radius, c * radius, center.X, center.Y) * Matrix;
+	}
+
+	private void CornerLine(in Vector2 center, float radius, int quadrant, float t, Color color)
+	{
+		if (radius <= 0)
+			return;
+
+		var table = GetQuarterTable(CornerSteps(radius));
+		var outer = CornerMatrix(center, radius, quadrant);
+
+		if (t >= radius)
+			Fan(outer, table, color, color);
+		else
+			Ring(CornerMatrix(center, radius - t, quadrant), outer, table, color);
+	}
+
+	/// <summary>
+	/// Pushes a triangle fan around the origin of the shape matrix, using the given unit points as the edge
+	/// </summary>
+	private void Fan(in Matrix3x2 shape, ReadOnlySpan<Vector2> points, in Color centerColor, in Color edgeColor)
+	{
+		var steps = points.Length - 1;
+		var vertices = points.Length + 1;
+
+		EnsureIndexCapacity(indexCount + steps * 3);
+		EnsureVertexCapacity(vertexCount + vertices);
+
+		unsafe
+		{
+			var indexArray = new Span<int>((int*)indexPtr + indexCount, steps * 3);
+			for (int i = 0, n = 0; i < steps; i++, n += 3)
+			{
+				indexArray[n + 0] = vertexCount + 1 + i;
+				indexArray[n + 1] = vertexCount + 2 + i;
+				indexArray[n + 2] = vertexCount;
+			}
+
+			var mode = new Color(0, 0, 255, 0);
+			var vertexArray = new Span<Vertex>((Vertex*)vertexPtr + vertexCount, vertices);
+
+			vertexArray[0] = new Vertex(shape.Translation, Vector2.Zero, centerColor, mode);
+			for (int i = 0; i < points.Length; i++)
+				vertexArray[i + 1] = new Vertex(Vector2.Transform(points[i], shape), Vector2.Zero, edgeColor, mode);
+		}
+
+		indexCount += steps * 3;
+		vertexCount += vertices;
+		currentBatch.Elements += steps;
+		dirty = true;
+	}
+
+	/// <summary>
+	/// Pushes a strip of quads between the inner and outer shape, using the given unit points as the edges
+	/// </summary>
+	private void Ring(in Matrix3x2 inner, in Matrix3x2 outer, ReadOnlySpan<Vector2> points, in Color color)
+	{
+		var steps = points.Length - 1;
+		var vertices = points.Length * 2;
+
+		EnsureIndexCapacity(indexCount + steps * 6);
+		EnsureVertexCapacity(vertexCount + vertices);
+
+		unsafe
+		{
+			var indexArray = new Span<int>((int*)indexPtr + indexCount, steps * 6);
+			for (int i = 0, n = 0; i < steps; i++, n += 6)
+			{
+				var a = vertexCount + i * 2;
+				indexArray[n + 0] = a + 0;
+				indexArray[n + 1] = a + 1;
+				indexArray[n + 2] = a + 3;
+				indexArray[n + 3] = a + 0;
+				indexArray[n + 4] = a + 3;
+				indexArray[n + 5] = a + 2;
+			}
+
+			var mode = new Color(0, 0, 255, 0);
+			var vertexArray = new Span<Vertex>((Vertex*)vertexPtr + vertexCount, vertices);
+
+			for (int i = 0; i < points.Length; i++)
+			{
+				vertexArray[i * 2 + 0] = new Vertex(Vector2.Transform(points[i], inner), Vector2.Zero, color, mode);
+				vertexArray[i * 2 + 1] = new Vertex(Vector2.Transform(points[i], outer), Vector2.Zero, color, mode);
+			}
+		}
+
+		indexCount += steps * 6;
+		vertexCount += vertices;
+		currentBatch.Elements += steps * 2;
+		dirty = true;
+	}
+
+	#endregion
+
 	#region Internal Utils
 
 	[MethodImpl(MethodImplOptions.AggressiveInlining)]
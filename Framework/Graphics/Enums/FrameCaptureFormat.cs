@@ -0,0 +1,16 @@
+namespace Foster.Framework;
+
+public enum FrameCaptureFormat
+{
+	/// <summary>
+	/// Each frame is written to its own numbered QOI file in the output directory
+	/// </summary>
+	QoiSequence,
+
+	/// <summary>
+	/// All frames are written uncompressed to a single file.
+	/// The file starts with the "FCAP" magic, a version, and the frame width and height as 32-bit integers.
+	/// Each frame follows as its 64-bit frame number, its 64-bit timestamp in ticks, and its RGBA pixels.
+	/// </summary>
+	Raw,
+}
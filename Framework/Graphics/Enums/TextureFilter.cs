@@ -4,4 +4,10 @@ public enum TextureFilter
 {
 	Nearest,
 	Linear,
+
+	/// <summary>
+	/// Linear filtering between and within mip levels.
+	/// Textures without mip levels are sampled the same as Linear.
+	/// </summary>
+	Trilinear,
 }
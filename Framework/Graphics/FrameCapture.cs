@@ -0,0 +1,290 @@
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// Records frames from the Window or a Target to disk without stalling the game loop.
+/// Frames are copied off the GPU asynchronously and handed to a background thread to be encoded.
+/// If the GPU or the encoder falls behind, frames are dropped instead of waiting for them.
+/// </summary>
+public class FrameCapture : IResource
+{
+	/// <summary>
+	/// Optional FrameCapture Name
+	/// </summary>
+	public string Name { get; set; } = string.Empty;
+
+	/// <summary>
+	/// If the FrameCapture has been disposed
+	/// </summary>
+	public bool IsDisposed => disposed;
+
+	/// <summary>
+	/// Width of the captured frames
+	/// </summary>
+	public readonly int Width;
+
+	/// <summary>
+	/// Height of the captured frames
+	/// </summary>
+	public readonly int Height;
+
+	/// <summary>
+	/// How the frames are written
+	/// </summary>
+	public readonly FrameCaptureFormat Format;
+
+	/// <summary>
+	/// The output directory for <see cref="FrameCaptureFormat.QoiSequence"/>, or file for <see cref="FrameCaptureFormat.Raw"/>
+	/// </summary>
+	public readonly string Path;
+
+	/// <summary>
+	/// Number of times <see cref="Capture(Target?)"/> has been called
+	/// </summary>
+	public int RequestedFrames { get; private set; }
+
+	/// <summary>
+	/// Number of frames that were dropped because the GPU or the encoder was behind
+	/// </summary>
+	public int DroppedFrames => Volatile.Read(ref dropped);
+
+	/// <summary>
+	/// Number of frames that have been written
+	/// </summary>
+	public int EncodedFrames => Volatile.Read(ref encoded);
+
+	private readonly record struct Frame(Color[] Pixels, int Number, TimeSpan Timestamp);
+
+	private struct Slot
+	{
+		public IntPtr Readback;
+		public int Number;
+		public TimeSpan Timestamp;
+	}
+
+	private readonly Slot[] slots;
+	private int pendingStart;
+	private int pendingCount;
+
+	private readonly BlockingCollection<Frame> queue;
+	private readonly ConcurrentBag<Color[]> buffers = new();
+	private readonly Thread worker;
+	private readonly Stream? rawStream;
+	private readonly Stopwatch timer = Stopwatch.StartNew();
+	private int dropped;
+	private int encoded;
+	private bool disposed = false;
+
+	private const int RawVersion = 1;
+
+	/// <param name="path">The output directory for a QOI sequence, or file for a raw capture</param>
+	/// <param name="width">Width of the captured frames, from the bottom-left of the source</param>
+	/// <param name="height">Height of the captured frames, from the bottom-left of the source</param>
+	/// <param name="maxQueuedFrames">How many frames may wait for the encoder before new ones are dropped</param>
+	/// <param name="readbackLatency">How many frames may be in flight on the GPU before new ones are dropped</param>
+	public FrameCapture(string path, int width, int height, FrameCaptureFormat format = FrameCaptureFormat.QoiSequence, int maxQueuedFrames = 4, int readbackLatency = 3)
+	{
+		if (width <= 0 || height <= 0)
+			throw new ArgumentException("FrameCapture width and height must be larger than 0");
+		if (maxQueuedFrames <= 0 || readbackLatency <= 0)
+			throw new ArgumentException("FrameCapture queue and latency must be larger than 0");
+
+		Width = width;
+		Height = height;
+		Format = format;
+		Path = path;
+
+		if (format == FrameCaptureFormat.QoiSequence)
+		{
+			Directory.CreateDirectory(path);
+		}
+		else
+		{
+			rawStream = File.Create(path);
+			Span<byte> header = stackalloc byte[16];
+			"FCAP"u8.CopyTo(header);
+			BitConverter.TryWriteBytes(header[4..], RawVersion);
+			BitConverter.TryWriteBytes(header[8..], width);
+			BitConverter.TryWriteBytes(header[12..], height);
+			rawStream.Write(header);
+		}
+
+		slots = new Slot[readbackLatency];
+		for (int i = 0; i < slots.Length; i++)
+		{
+			slots[i].Readback = Platform.FosterReadbackCreate(width, height);
+			if (slots[i].Readback == IntPtr.Zero)
+			{
+				for (int j = 0; j < i; j++)
+					Graphics.Resources.RequestDelete(slots[j].Readback);
+				rawStream?.Dispose();
+				throw new Exception("Failed to create FrameCapture Readback");
+			}
+			Graphics.Resources.RegisterAllocated(this, slots[i].Readback, Platform.FosterReadbackDestroy);
+		}
+
+		queue = new(new ConcurrentQueue<Frame>(), maxQueuedFrames);
+		worker = new Thread(Encode) { Name = "Foster FrameCapture", IsBackground = true };
+		worker.Start();
+	}
+
+	/// <summary>
+	/// Requests a copy of the Target, or the Window if null, and hands any finished copies to the encoder.
+	/// Call this once per frame after drawing, before the frame ends.
+	/// This never waits on the GPU or the encoder.
+	/// </summary>
+	public void Capture(Target? target = null)
+	{
+		if (IsDisposed)
+			throw new Exception("Resource is Disposed");
+		if (target != null && target.IsDisposed)
+			throw new Exception("Target is Disposed");
+
+		Collect(wait: false);
+
+		var number = RequestedFrames++;
+
+		// every readback is still in flight, so the GPU is too far behind to take another
+		if (pendingCount >= slots.Length)
+		{
+			Interlocked.Increment(ref dropped);
+			return;
+		}
+
+		ref var slot = ref slots[(pendingStart + pendingCount) % slots.Length];
+		slot.Number = number;
+		slot.Timestamp = timer.Elapsed;
+		Platform.FosterReadbackRequest(slot.Readback, target?.resource ?? IntPtr.Zero, 0, 0);
+		pendingCount++;
+	}
+
+	/// <summary>
+	/// Waits for every requested frame to be copied and encoded
+	/// </summary>
+	public void Flush()
+	{
+		if (IsDisposed)
+			throw new Exception("Resource is Disposed");
+
+		Collect(wait: true);
+		while (Volatile.Read(ref encoded) + Volatile.Read(ref dropped) < RequestedFrames)
+			Thread.Sleep(1);
+	}
+
+	private unsafe void Collect(bool wait)
+	{
+		// readbacks finish in the order they were requested
+		while (pendingCount > 0)
+		{
+			ref var slot = ref slots[pendingStart];
+			if (!wait && Platform.FosterReadbackReady(slot.Readback) == 0)
+				break;
+
+			pendingStart = (pendingStart + 1) % slots.Length;
+			pendingCount--;
+
+			// the encoder is behind, so skip copying the pixels at all
+			if (!wait && queue.Count >= queue.BoundedCapacity)
+			{
+				Interlocked.Increment(ref dropped);
+				continue;
+			}
+
+			if (!buffers.TryTake(out var pixels))
+				pixels = new Color[Width * Height];
+
+			fixed (Color* ptr = pixels)
+			{
+				if (Platform.FosterReadbackGetData(slot.Readback, ptr, pixels.Length * 4) == 0)
+				{
+					buffers.Add(pixels);
+					Interlocked.Increment(ref dropped);
+					continue;
+				}
+			}
+
+			var frame = new Frame(pixels, slot.Number, slot.Timestamp);
+			if (wait)
+			{
+				queue.Add(frame);
+			}
+			else if (!queue.TryAdd(frame))
+			{
+				buffers.Add(pixels);
+				Interlocked.Increment(ref dropped);
+			}
+		}
+	}
+
+	private void Encode()
+	{
+		Span<byte> header = stackalloc byte[16];
+
+		foreach (var frame in queue.GetConsumingEnumerable())
+		{
+			try
+			{
+				// the GPU's rows are bottom-up on some renderers
+				if (Graphics.OriginBottomLeft)
+				{
+					var pixels = frame.Pixels.AsSpan();
+					for (int top = 0, bottom = Height - 1; top < bottom; top++, bottom--)
+					{
+						var a = pixels.Slice(top * Width, Width);
+						var b = pixels.Slice(bottom * Width, Width);
+						for (int i = 0; i < Width; i++)
+							(a[i], b[i]) = (b[i], a[i]);
+					}
+				}
+
+				if (Format == FrameCaptureFormat.QoiSequence)
+				{
+					using var image = new Image(Width, Height, frame.Pixels);
+					using var stream = File.Create(System.IO.Path.Combine(Path, $"frame_{frame.Number:D6}.qoi"));
+					image.WriteQoi(stream);
+				}
+				else
+				{
+					BitConverter.TryWriteBytes(header, (long)frame.Number);
+					BitConverter.TryWriteBytes(header[8..], frame.Timestamp.Ticks);
+					rawStream!.Write(header);
+					rawStream.Write(MemoryMarshal.AsBytes(frame.Pixels.AsSpan()));
+				}
+
+				Interlocked.Increment(ref encoded);
+			}
+			catch (Exception e)
+			{
+				Log.Error($"Failed to write captured frame {frame.Number}: {e.Message}");
+				Interlocked.Increment(ref dropped);
+			}
+
+			buffers.Add(frame.Pixels);
+		}
+	}
+
+	/// <summary>
+	/// Finishes writing every requested frame and closes the output.
+	/// This must be called from the main thread, as it waits on the GPU for frames still in flight.
+	/// </summary>
+	public void Dispose()
+	{
+		if (disposed)
+			return;
+
+		Collect(wait: true);
+		queue.CompleteAdding();
+		worker.Join();
+		queue.Dispose();
+		rawStream?.Dispose();
+
+		foreach (var slot in slots)
+			Graphics.Resources.RequestDelete(slot.Readback);
+
+		disposed = true;
+		GC.SuppressFinalize(this);
+	}
+}
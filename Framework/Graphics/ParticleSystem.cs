@@ -0,0 +1,306 @@
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// A fixed-capacity pool of particles stored as separate arrays per property (structure-of-arrays).
+/// Updates run over whole arrays using SIMD, and are split across cores for large pools.
+/// Particles are drawn by writing quads directly into a Batcher's vertex memory.
+/// </summary>
+public class ParticleSystem
+{
+	/// <summary>
+	/// Maximum number of live particles
+	/// </summary>
+	public readonly int Capacity;
+
+	/// <summary>
+	/// Number of live particles. Live particles are always stored at the start of each array.
+	/// </summary>
+	public int Count { get; private set; }
+
+	/// <summary>
+	/// Constant acceleration applied to every particle, in units per second squared
+	/// </summary>
+	public Vector2 Gravity = Vector2.Zero;
+
+	/// <summary>
+	/// Velocity damping, as the fraction of velocity lost per second
+	/// </summary>
+	public float Drag = 0;
+
+	/// <summary>
+	/// If particles fade to transparent over their lifetime when drawn
+	/// </summary>
+	public bool FadeOut = true;
+
+	/// <summary>
+	/// Pools with at least this many live particles update in parallel
+	/// </summary>
+	public int ParallelThreshold = 16384;
+
+	/// <summary>
+	/// Particle Positions
+	/// </summary>
+	public Span<Vector2> Positions => positions.AsSpan(0, Count);
+
+	/// <summary>
+	/// Particle Velocities, in units per second
+	/// </summary>
+	public Span<Vector2> Velocities => velocities.AsSpan(0, Count);
+
+	/// <summary>
+	/// Remaining life of each Particle, in seconds
+	/// </summary>
+	public Span<float> Life => life.AsSpan(0, Count);
+
+	/// <summary>
+	/// Total lifetime each Particle was emitted with, in seconds
+	/// </summary>
+	public Span<float> Lifetimes => lifetimes.AsSpan(0, Count);
+
+	/// <summary>
+	/// Particle Colors
+	/// </summary>
+	public Span<Color> Colors => colors.AsSpan(0, Count);
+
+	/// <summary>
+	/// Particle Sizes, as a scale of the drawn Subtexture
+	/// </summary>
+	public Span<float> Sizes => sizes.AsSpan(0, Count);
+
+	private readonly Vector2[] positions;
+	private readonly Vector2[] velocities;
+	private readonly float[] life;
+	private readonly float[] lifetimes;
+	private readonly Color[] colors;
+	private readonly float[] sizes;
+
+	/// <summary>
+	/// Particles per parallel work item. A multiple of every SIMD width so each range stays vectorized.
+	/// </summary>
+	private const int ParallelBlockSize = 4096;
+
+	public ParticleSystem(int capacity)
+	{
+		if (capacity <= 0)
+			throw new ArgumentException("ParticleSystem capacity must be larger than 0");
+
+		Capacity = capacity;
+		positions = new Vector2[capacity];
+		velocities = new Vector2[capacity];
+		life = new float[capacity];
+		lifetimes = new float[capacity];
+		colors = new Color[capacity];
+		sizes = new float[capacity];
+	}
+
+	/// <summary>
+	/// Emits a single particle. Returns its index, or -1 if the pool is full.
+	/// </summary>
+	public int Emit(in Vector2 position, in Vector2 velocity, float lifetime, Color color, float size = 1)
+	{
+		if (Count >= Capacity || lifetime <= 0)
+			return -1;
+
+		var i = Count++;
+		positions[i] = position;
+		velocities[i] = velocity;
+		life[i] = lifetime;
+		lifetimes[i] = lifetime;
+		colors[i] = color;
+		sizes[i] = size;
+		return i;
+	}
+
+	/// <summary>
+	/// Removes all particles
+	/// </summary>
+	public void Clear()
+	{
+		Count = 0;
+	}
+
+	/// <summary>
+	/// Advances every particle by the given time, and removes particles whose life has run out
+	/// </summary>
+	public void Update(float delta)
+	{
+		if (Count <= 0)
+			return;
+
+		if (Count >= ParallelThreshold)
+		{
+			var blocks = (Count + ParallelBlockSize - 1) / ParallelBlockSize;
+			Parallel.For(0, blocks, b =>
+			{
+				var from = b * ParallelBlockSize;
+				UpdateRange(from, Math.Min(Count, from + ParallelBlockSize), delta);
+			});
+		}
+		else
+		{
+			UpdateRange(0, Count, delta);
+		}
+
+		RemoveDead();
+	}
+
+	private void UpdateRange(int from, int to, float delta)
+	{
+		var count = to - from;
+
+		// positions & velocities are interleaved (x, y) floats, so they can be processed as flat float spans
+		var pos = MemoryMarshal.Cast<Vector2, float>(positions.AsSpan(from, count));
+		var vel = MemoryMarshal.Cast<Vector2, float>(velocities.AsSpan(from, count));
+		var lf = life.AsSpan(from, count);
+
+		var damping = MathF.Max(0, 1.0f - Drag * delta);
+		var gx = Gravity.X * delta;
+		var gy = Gravity.Y * delta;
+		var i = 0;
+
+		if (Vector.IsHardwareAccelerated)
+		{
+			// vector widths are always even, so an (x, y) repeating pattern lines up with every vector
+			Span<float> pattern = stackalloc float[Vector<float>.Count];
+			for (int n = 0; n < pattern.Length; n += 2)
+			{
+				pattern[n + 0] = gx;
+				pattern[n + 1] = gy;
+			}
+
+			var gravity = new Vector<float>(pattern);
+			var dt = new Vector<float>(delta);
+			var damp = new Vector<float>(damping);
+			var vpos = MemoryMarshal.Cast<float, Vector<float>>(pos);
+			var vvel = MemoryMarshal.Cast<float, Vector<float>>(vel);
+
+			for (int n = 0; n < vpos.Length; n++)
+			{
+				var v = (vvel[n] + gravity) * damp;
+				vvel[n] = v;
+				vpos[n] += v * dt;
+			}
+
+			var vlife = MemoryMarshal.Cast<float, Vector<float>>(lf);
+			for (int n = 0; n < vlife.Length; n++)
+				vlife[n] -= dt;
+
+			i = vpos.Length * Vector<float>.Count;
+			for (int n = vlife.Length * Vector<float>.Count; n < lf.Length; n++)
+				lf[n] -= delta;
+		}
+		else
+		{
+			for (int n = 0; n < lf.Length; n++)
+				lf[n] -= delta;
+		}
+
+		// remaining components that didn't fill a whole vector
+		for (; i < pos.Length; i += 2)
+		{
+			vel[i + 0] = (vel[i + 0] + gx) * damping;
+			vel[i + 1] = (vel[i + 1] + gy) * damping;
+			pos[i + 0] += vel[i + 0] * delta;
+			pos[i + 1] += vel[i + 1] * delta;
+		}
+	}
+
+	private void RemoveDead()
+	{
+		// swap-remove dead particles with the last live one, so live particles stay packed at the start
+		var i = 0;
+		while (i < Count)
+		{
+			if (life[i] > 0)
+			{
+				i++;
+				continue;
+			}
+
+			var last = --Count;
+			positions[i] = positions[last];
+			velocities[i] = velocities[last];
+			life[i] = life[last];
+			lifetimes[i] = lifetimes[last];
+			colors[i] = colors[last];
+			sizes[i] = sizes[last];
+		}
+	}
+
+	/// <summary>
+	/// Draws every particle as the given Subtexture, centered on the particle position.
+	/// Vertices are written directly into the Batcher, using its current Matrix.
+	/// </summary>
+	public unsafe void Render(Batcher batcher, in Subtexture subtexture)
+	{
+		if (Count <= 0 || subtexture.Texture == null)
+			return;
+
+		batcher.SetTexture(subtexture.Texture);
+
+		var matrix = batcher.Matrix;
+		var center = new Vector2(subtexture.Width, subtexture.Height) * 0.5f;
+		var o0 = Vector2.TransformNormal(subtexture.DrawCoords0 - center, matrix);
+		var o1 = Vector2.TransformNormal(subtexture.DrawCoords1 - center, matrix);
+		var o2 = Vector2.TransformNormal(subtexture.DrawCoords2 - center, matrix);
+		var o3 = Vector2.TransformNormal(subtexture.DrawCoords3 - center, matrix);
+
+		var t0 = subtexture.TexCoords0;
+		var t1 = subtexture.TexCoords1;
+		var t2 = subtexture.TexCoords2;
+		var t3 = subtexture.TexCoords3;
+		if (subtexture.Texture.IsTargetAttachment && Graphics.OriginBottomLeft)
+		{
+			t0.Y = 1.0f - t0.Y;
+			t1.Y = 1.0f - t1.Y;
+			t2.Y = 1.0f - t2.Y;
+			t3.Y = 1.0f - t3.Y;
+		}
+
+		var count = Count;
+		var fade = FadeOut;
+		var mode = new Color(255, 0, 0, 0);
+		var vertices = batcher.ReserveQuads(count);
+
+		fixed (Batcher.Vertex* ptr = vertices)
+		{
+			// the vertex memory is unmanaged, so the pointer stays valid across worker threads
+			var dst = ptr;
+
+			void Write(int from, int to)
+			{
+				var v = dst + from * 4;
+				for (int i = from; i < to; i++, v += 4)
+				{
+					var p = Vector2.Transform(positions[i], matrix);
+					var s = sizes[i];
+					var c = colors[i];
+					if (fade)
+						c *= Math.Clamp(life[i] / lifetimes[i], 0, 1);
+
+					v[0] = new(p + o0 * s, t0, c, mode);
+					v[1] = new(p + o1 * s, t1, c, mode);
+					v[2] = new(p + o2 * s, t2, c, mode);
+					v[3] = new(p + o3 * s, t3, c, mode);
+				}
+			}
+
+			if (count >= ParallelThreshold)
+			{
+				var blocks = (count + ParallelBlockSize - 1) / ParallelBlockSize;
+				Parallel.For(0, blocks, b =>
+				{
+					var from = b * ParallelBlockSize;
+					Write(from, Math.Min(count, from + ParallelBlockSize));
+				});
+			}
+			else
+			{
+				Write(0, count);
+			}
+		}
+	}
+}
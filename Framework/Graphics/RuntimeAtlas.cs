@@ -0,0 +1,260 @@
+namespace Foster.Framework;
+
+/// <summary>
+/// A Texture atlas that images can be added to and removed from at runtime, without repacking it.
+/// Each page keeps track of its free space between insertions, and new images are uploaded
+/// straight into the page Texture. Removing images fragments the free space over time,
+/// which <see cref="Defragment"/> recovers by repacking everything that's left.
+/// </summary>
+public class RuntimeAtlas : IDisposable
+{
+	/// <summary>
+	/// The Width and Height of each page
+	/// </summary>
+	public readonly int PageSize;
+
+	/// <summary>
+	/// Transparent space left to the right and below each image, to avoid bleeding when sampling
+	/// </summary>
+	public readonly int Padding;
+
+	/// <summary>
+	/// The page Textures
+	/// </summary>
+	public IReadOnlyList<Texture> Pages => pages;
+
+	/// <summary>
+	/// The number of images in the atlas
+	/// </summary>
+	public int Count => sprites.Count;
+
+	/// <summary>
+	/// Incremented whenever images are moved by <see cref="Defragment"/>.
+	/// Subtextures taken from the atlas before then need to be fetched again.
+	/// </summary>
+	public int Version { get; private set; }
+
+	/// <summary>
+	/// How much of the pages are covered by images, from 0 to 1
+	/// </summary>
+	public float Occupancy => pages.Count > 0 ? usedArea / ((float)PageSize * PageSize * pages.Count) : 0;
+
+	private struct Sprite
+	{
+		public int Page;
+		public RectInt Rect;
+		public Color[] Pixels;
+	}
+
+	private readonly List<Texture> pages = [];
+	private readonly List<MaxRectsBin> bins = [];
+	private readonly List<int> pageCounts = [];
+	private readonly Dictionary<int, Sprite> sprites = [];
+	private Color[] buffer = [];
+	private long usedArea;
+	private int nextId;
+
+	public RuntimeAtlas(int pageSize = 2048, int padding = 1)
+	{
+		if (pageSize <= 0)
+			throw new ArgumentException("RuntimeAtlas page size must be larger than 0");
+		if (padding < 0)
+			throw new ArgumentException("RuntimeAtlas padding can't be negative");
+
+		PageSize = pageSize;
+		Padding = padding;
+	}
+
+	/// <summary>
+	/// Adds an image to the atlas and returns its ID
+	/// </summary>
+	public int Add(Image image)
+	{
+		return Add(image.Width, image.Height, image.Data);
+	}
+
+	/// <summary>
+	/// Adds an image to the atlas and returns its ID
+	/// </summary>
+	public int Add(int width, int height, ReadOnlySpan<Color> pixels)
+	{
+		if (width <= 0 || height <= 0)
+			throw new ArgumentException("Image must have a size larger than 0");
+		if (pixels.Length < width * height)
+			throw new ArgumentException("Pixel buffer is smaller than the Size of the Image");
+		if (width + Padding > PageSize || height + Padding > PageSize)
+			throw new Exception("Image is larger than the RuntimeAtlas page size");
+
+		var sprite = new Sprite { Pixels = pixels[..(width * height)].ToArray() };
+		Place(ref sprite, width, height);
+		Upload(sprite);
+
+		var id = nextId++;
+		sprites.Add(id, sprite);
+		usedArea += width * height;
+		return id;
+	}
+
+	/// <summary>
+	/// Removes an image from the atlas, returning its space to its page.
+	/// The page Texture isn't changed until something else is placed there.
+	/// </summary>
+	public bool Remove(int id)
+	{
+		if (!sprites.Remove(id, out var sprite))
+			return false;
+
+		// an empty page can start over, rather than keep its fragmented free space
+		if (--pageCounts[sprite.Page] <= 0)
+			bins[sprite.Page].Reset(PageSize, PageSize);
+		else
+			bins[sprite.Page].Free(Cell(sprite.Rect));
+
+		usedArea -= sprite.Rect.Width * sprite.Rect.Height;
+		return true;
+	}
+
+	/// <summary>
+	/// If the atlas has an image with the given ID
+	/// </summary>
+	public bool Contains(int id)
+	{
+		return sprites.ContainsKey(id);
+	}
+
+	/// <summary>
+	/// Gets the Subtexture of an image in the atlas, or an empty Subtexture if it isn't in the atlas
+	/// </summary>
+	public Subtexture GetSubtexture(int id)
+	{
+		if (sprites.TryGetValue(id, out var sprite))
+			return new Subtexture(pages[sprite.Page], sprite.Rect);
+		return Subtexture.Empty;
+	}
+
+	/// <summary>
+	/// Repacks every image from scratch, largest first, and reuploads the pages.
+	/// Pages left empty afterwards are disposed.
+	/// This moves images, so it increments <see cref="Version"/>.
+	/// </summary>
+	public void Defragment()
+	{
+		var ids = sprites.Keys.ToArray();
+		Array.Sort(ids, (a, b) =>
+		{
+			RectInt ra = sprites[a].Rect, rb = sprites[b].Rect;
+			var side = Math.Max(rb.Width, rb.Height) - Math.Max(ra.Width, ra.Height);
+			return side != 0 ? side : rb.Width * rb.Height - ra.Width * ra.Height;
+		});
+
+		for (int i = 0; i < bins.Count; i++)
+		{
+			bins[i].Reset(PageSize, PageSize);
+			pageCounts[i] = 0;
+		}
+
+		var used = 0;
+		foreach (var id in ids)
+		{
+			var sprite = sprites[id];
+			Place(ref sprite, sprite.Rect.Width, sprite.Rect.Height);
+			sprites[id] = sprite;
+			used = Math.Max(used, sprite.Page + 1);
+		}
+
+		for (int i = pages.Count - 1; i >= used; i--)
+		{
+			pages[i].Dispose();
+			pages.RemoveAt(i);
+			bins.RemoveAt(i);
+			pageCounts.RemoveAt(i);
+		}
+
+		// redraw each page in full, which also clears whatever was left by removed images
+		if (buffer.Length < PageSize * PageSize)
+			buffer = new Color[PageSize * PageSize];
+
+		for (int page = 0; page < pages.Count; page++)
+		{
+			Array.Clear(buffer);
+			foreach (var sprite in sprites.Values)
+			{
+				if (sprite.Page != page)
+					continue;
+
+				for (int y = 0; y < sprite.Rect.Height; y++)
+					sprite.Pixels.AsSpan(y * sprite.Rect.Width, sprite.Rect.Width).CopyTo(buffer.AsSpan(sprite.Rect.X + (sprite.Rect.Y + y) * PageSize));
+			}
+			pages[page].SetData<Color>(buffer);
+		}
+
+		Version++;
+	}
+
+	/// <summary>
+	/// Disposes the page Textures and removes every image
+	/// </summary>
+	public void Dispose()
+	{
+		foreach (var page in pages)
+			page.Dispose();
+		pages.Clear();
+		bins.Clear();
+		pageCounts.Clear();
+		sprites.Clear();
+		usedArea = 0;
+		GC.SuppressFinalize(this);
+	}
+
+	private RectInt Cell(in RectInt rect)
+		=> new(rect.X, rect.Y, rect.Width + Padding, rect.Height + Padding);
+
+	private void Place(ref Sprite sprite, int width, int height)
+	{
+		for (int i = 0; i <= pages.Count; i++)
+		{
+			if (i == pages.Count)
+				AddPage();
+
+			if (bins[i].TryInsert(width + Padding, height + Padding, false, out var cell, out _))
+			{
+				sprite.Page = i;
+				sprite.Rect = new RectInt(cell.X, cell.Y, width, height);
+				pageCounts[i]++;
+				return;
+			}
+		}
+	}
+
+	private void Upload(in Sprite sprite)
+	{
+		var rect = sprite.Rect;
+		if (Padding <= 0)
+		{
+			pages[sprite.Page].SetData<Color>(rect, sprite.Pixels);
+			return;
+		}
+
+		// the full cell is uploaded so the padding clears anything left by removed images
+		var cell = Cell(rect);
+		if (buffer.Length < cell.Width * cell.Height)
+			Array.Resize(ref buffer, cell.Width * cell.Height);
+
+		var data = buffer.AsSpan(0, cell.Width * cell.Height);
+		data.Clear();
+		for (int y = 0; y < rect.Height; y++)
+			sprite.Pixels.AsSpan(y * rect.Width, rect.Width).CopyTo(data[(y * cell.Width)..]);
+
+		pages[sprite.Page].SetData<Color>(cell, data);
+	}
+
+	private void AddPage()
+	{
+		// textures are created with undefined contents, so clear it
+		var page = new Texture(PageSize, PageSize) { Name = "Runtime Atlas" };
+		page.SetData<Color>(new Color[PageSize * PageSize]);
+		pages.Add(page);
+		bins.Add(new MaxRectsBin(PageSize, PageSize));
+		pageCounts.Add(0);
+	}
+}
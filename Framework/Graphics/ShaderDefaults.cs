@@ -33,10 +33,13 @@ internal static class ShaderDefaults
 				void main(void)
 				{
 					vec4 color = texture(u_texture, v_tex);
+					float width = max(fwidth(color.a), 0.0001);
+					float field = smoothstep(0.5 - width, 0.5 + width, color.a);
 					o_color = 
 						v_type.x * color * v_col + 
 						v_type.y * color.a * v_col + 
-						v_type.z * v_col;
+						v_type.z * v_col +
+						v_type.w * field * v_col;
 				}"
 		}
 	};
@@ -1,4 +1,7 @@
 using System.Numerics;
+using System.Runtime.InteropServices;
+using System.Security.Cryptography;
+using System.Text;
 
 namespace Foster.Framework;
 
@@ -77,8 +80,56 @@ public class SpriteFont
 	/// </summary>
 	public float LineHeight => Ascent - Descent + LineGap;
 
-	private readonly Dictionary<int, Character> characters = new();
+	/// <summary>
+	/// Codepoints below this value are looked up through a flat index table,
+	/// while anything above it falls back to a Dictionary.
+	/// </summary>
+	public const int DenseCodepointLimit = 0x10000;
+
+	/// <summary>
+	/// Kerning is stored in a flat [first, second] matrix while the number of
+	/// Characters is at most this value, and falls back to a Dictionary above it.
+	/// </summary>
+	public const int MaxKerningMatrixSize = 512;
+
+	// characters are stored in a flat array, and codepoints map to their slot
+	private Character[] characters = [];
+	private int characterCount;
+	private int[] denseIndex = [];
+	private readonly Dictionary<int, int> sparseIndex = new();
+
+	// kerning pairs, with a lazily built matrix of character slots for fast lookup
 	private readonly Dictionary<KerningPair, float> kerning = new();
+	private float[]? kerningMatrix;
+	private int kerningStride;
+
+	// rasterizes characters on demand, if this is a dynamic SpriteFont
+	private readonly DynamicAtlas? dynamic;
+
+	// atlas pages of a non-dynamic SpriteFont
+	private readonly List<Texture> pages = [];
+
+	/// <summary>
+	/// If this SpriteFont rasterizes characters the first time they are requested
+	/// </summary>
+	public bool IsDynamic => dynamic != null;
+
+	/// <summary>
+	/// If the characters are Signed Distance Fields, which the Batcher draws smoothly at any scale.
+	/// See <see cref="CreateDistanceField(Font, float, ReadOnlySpan{int}, int)"/>.
+	/// </summary>
+	public bool IsDistanceField => DistanceFieldPadding > 0;
+
+	/// <summary>
+	/// Distance, in pixels at the Font Size, that the Signed Distance Field extends past each character edge
+	/// </summary>
+	public int DistanceFieldPadding { get; private set; }
+
+	/// <summary>
+	/// Incremented whenever a dynamic SpriteFont evicts characters from its atlas,
+	/// which invalidates any Subtextures previously returned for those characters.
+	/// </summary>
+	public int AtlasVersion => dynamic?.Version ?? 0;
 
 	static SpriteFont()
 	{
@@ -119,7 +170,44 @@ public class SpriteFont
 		InitializeFromFont(font, size, codepoints);
 	}
 
-	private void InitializeFromFont(Font font, float size, ReadOnlySpan<int> codepoints)
+	/// <summary>
+	/// Creates a dynamic SpriteFont, which rasterizes characters from the Font the first time they are requested.
+	/// Characters are shelf-packed into atlas pages of the given size, and once <paramref name="maxPages"/> pages
+	/// are full the least recently used characters are evicted to make room.
+	/// The Font is not owned by the SpriteFont, and must not be disposed while it is in use.
+	/// </summary>
+	public SpriteFont(Font font, float size, int pageSize, int maxPages)
+	{
+		if (pageSize <= 0 || maxPages <= 0)
+			throw new ArgumentException("Dynamic SpriteFont page size and count must be larger than 0");
+
+		SetMetrics(font, size);
+		dynamic = new DynamicAtlas(font, font.GetScale(size), pageSize, maxPages);
+	}
+
+	/// <summary>
+	/// Creates a SpriteFont whose characters are Signed Distance Fields rasterized at the given size.
+	/// A single Distance Field SpriteFont can be drawn at any scale by scaling the Batcher Matrix,
+	/// where (Size * scale) is the resulting font size. Larger padding allows larger scales and effects
+	/// at the cost of atlas space.
+	/// </summary>
+	public static SpriteFont CreateDistanceField(Font font, float size, ReadOnlySpan<int> codepoints, int padding = 4)
+	{
+		if (padding <= 0)
+			throw new ArgumentException("Distance Field padding must be larger than 0");
+
+		var result = new SpriteFont();
+		result.InitializeFromFont(font, size, codepoints, padding);
+		return result;
+	}
+
+	/// <summary>
+	/// Creates a SpriteFont of the ASCII characters, as Signed Distance Fields rasterized at the given size.
+	/// </summary>
+	public static SpriteFont CreateDistanceField(Font font, float size, int padding = 4)
+		=> CreateDistanceField(font, size, Ascii, padding);
+
+	private void SetMetrics(Font font, float size)
 	{
 		// get font scale
 		var scale = font.GetScale(size);
@@ -129,9 +217,65 @@ public class SpriteFont
 		Ascent = font.Ascent * scale;
 		Descent = font.Descent * scale;
 		LineGap = font.LineGap * scale;
+	}
 
-		// create a buffer that should be large enough for any character
-		var buffer = new Color[(int)(size * size)];
+	/// <summary>
+	/// Number of characters rasterized per parallel work item when building a SpriteFont
+	/// </summary>
+	private const int RasterizeBlockSize = 64;
+
+	private void InitializeFromFont(Font font, float size, ReadOnlySpan<int> codepoints, int distanceFieldPadding = 0)
+	{
+		// get font scale
+		var scale = font.GetScale(size);
+
+		// setup size based on the font given
+		SetMetrics(font, size);
+		DistanceFieldPadding = distanceFieldPadding;
+
+		// get the metrics of every character, and where its pixels go in one shared buffer
+		var metrics = new Font.Character[codepoints.Length];
+		var offsets = new int[codepoints.Length + 1];
+		for (int i = 0; i < codepoints.Length; i++)
+		{
+			var glyph = font.GetGlyphIndex(codepoints[i]);
+			metrics[i] = font.GetCharacterOfGlyph(glyph, scale);
+			if (distanceFieldPadding > 0)
+				metrics[i] = font.GetDistanceFieldCharacter(metrics[i], distanceFieldPadding);
+
+			offsets[i + 1] = offsets[i] + (metrics[i].Visible ? metrics[i].Width * metrics[i].Height : 0);
+
+			AddCharacter(new(
+				codepoints[i],
+				new Subtexture(),
+				metrics[i].Advance,
+				metrics[i].Offset
+			));
+		}
+
+		// load kerning between every character in the set from the Font's tables
+		LoadKerning(font, scale, codepoints, metrics);
+
+		// rasterize the characters in blocks, across threads for larger sets.
+		// each block writes to its own range of the buffer, so no locking is needed.
+		var buffer = new Color[offsets[codepoints.Length]];
+		var blocks = (metrics.Length + RasterizeBlockSize - 1) / RasterizeBlockSize;
+		var rasterized = new bool[blocks];
+
+		void Rasterize(int block)
+		{
+			var from = block * RasterizeBlockSize;
+			var to = Math.Min(metrics.Length, from + RasterizeBlockSize);
+			rasterized[block] = font.GetPixels(
+				metrics.AsSpan(from, to - from),
+				buffer.AsSpan(offsets[from], offsets[to] - offsets[from]),
+				distanceFieldPadding);
+		}
+
+		if (blocks > 1)
+			Parallel.For(0, blocks, Rasterize);
+		else if (blocks == 1)
+			Rasterize(0);
 
 		// create sprite packer
 		var packer = new Packer
@@ -142,35 +286,20 @@ public class SpriteFont
 		};
 
 		// add each character
-		foreach (var codepoint in codepoints)
+		for (int i = 0; i < metrics.Length; i++)
 		{
-			var glyph = font.GetGlyphIndex(codepoint);
-			var metrics = font.GetCharacterOfGlyph(glyph, scale);
-
-			if (metrics.Visible)
+			if (metrics[i].Visible && rasterized[i / RasterizeBlockSize])
 			{
-				if (buffer.Length < metrics.Width * metrics.Height)
-					Array.Resize(ref buffer, metrics.Width * metrics.Height);
-
-				if (font.GetPixels(metrics, buffer))
-				{
-					packer.Add(codepoint, string.Empty, metrics.Width, metrics.Height, buffer);
-				}
+				var pixels = buffer.AsSpan(offsets[i], offsets[i + 1] - offsets[i]);
+				packer.Add(codepoints[i], string.Empty, metrics[i].Width, metrics[i].Height, pixels);
 			}
-
-			characters.Add(codepoint, new(
-				codepoint,
-				new Subtexture(),
-				metrics.Advance,
-				metrics.Offset
-			));
 		}
 
 		// pack characters into textures
 		var result = packer.Pack();
-		var textures = new List<Texture>();
+		var textures = pages;
 		foreach (var page in result.Pages)
-			textures.Add(new(page));
+			textures.Add(CreateCoverageTexture(page.Width, page.Height, page.Data));
 
 		// update subtextures of all the created characters
 		foreach (var packed in result.Entries)
@@ -181,8 +310,291 @@ public class SpriteFont
 				packed.Source,
 				packed.Frame);
 
-			characters[codepoint] = characters[codepoint] with { Subtexture = subtexture };
+			var slot = GetSlot(codepoint);
+			characters[slot] = characters[slot] with { Subtexture = subtexture };
+		}
+	}
+
+	private void LoadKerning(Font font, float scale, ReadOnlySpan<int> codepoints, Font.Character[] metrics)
+	{
+		// several codepoints can share a glyph, so find the unique glyphs and which codepoints use them
+		var glyphs = new List<int>();
+		var glyphCodepoints = new List<List<int>>();
+		var glyphLookup = new Dictionary<int, int>();
+		for (int i = 0; i < codepoints.Length; i++)
+		{
+			// glyph 0 is the missing character glyph
+			var glyph = metrics[i].GlyphIndex;
+			if (glyph == 0)
+				continue;
+
+			if (!glyphLookup.TryGetValue(glyph, out var index))
+			{
+				glyphLookup[glyph] = index = glyphs.Count;
+				glyphs.Add(glyph);
+				glyphCodepoints.Add([]);
+			}
+
+			glyphCodepoints[index].Add(codepoints[i]);
+		}
+
+		foreach (var pair in font.GetKerningPairs(CollectionsMarshal.AsSpan(glyphs), scale))
+		{
+			foreach (var a in glyphCodepoints[pair.First])
+				foreach (var b in glyphCodepoints[pair.Second])
+					SetKerning(a, b, pair.Advance);
+		}
+	}
+
+	/// <summary>
+	/// Version of the binary format written by <see cref="Write(Stream)"/>.
+	/// Bump this whenever the format or the way SpriteFonts are built changes, so cached files are rebuilt.
+	/// </summary>
+	private const int CacheVersion = 1;
+
+	private static ReadOnlySpan<byte> CacheMagic => "FSPF"u8;
+
+	/// <summary>
+	/// Loads a SpriteFont from a cache file in the given directory, which skips parsing the Font,
+	/// rasterizing and packing entirely. If there is no cache file for this font file, size and codepoint set,
+	/// or it is unreadable, the SpriteFont is built from the Font file and a new cache file is written.
+	/// </summary>
+	public static SpriteFont FromCache(string fontPath, float size, string cacheDirectory)
+		=> FromCache(fontPath, size, Ascii, cacheDirectory);
+
+	/// <summary>
+	/// Loads a SpriteFont from a cache file in the given directory, which skips parsing the Font,
+	/// rasterizing and packing entirely. If there is no cache file for this font file, size and codepoint set,
+	/// or it is unreadable, the SpriteFont is built from the Font file and a new cache file is written.
+	/// </summary>
+	/// <param name="distanceFieldPadding">If larger than 0, builds a Distance Field SpriteFont with this padding</param>
+	public static SpriteFont FromCache(string fontPath, float size, ReadOnlySpan<int> codepoints, string cacheDirectory, int distanceFieldPadding = 0)
+	{
+		var fontData = File.ReadAllBytes(fontPath);
+		var key = GetCacheKey(fontData, size, codepoints, distanceFieldPadding);
+		var cachePath = Path.Combine(cacheDirectory, $"{Convert.ToHexString(key, 0, 16)}.spritefont");
+
+		// try loading the existing cache file
+		if (File.Exists(cachePath))
+		{
+			try
+			{
+				using var stream = File.OpenRead(cachePath);
+				if (TryRead(stream, key, out var cached))
+					return cached;
+			}
+			catch (Exception e)
+			{
+				Log.Warning($"Failed to read SpriteFont cache '{cachePath}': {e.Message}");
+			}
+		}
+
+		// otherwise build it
+		SpriteFont result;
+		using (var font = new Font(new MemoryStream(fontData)))
+		{
+			if (distanceFieldPadding > 0)
+				result = CreateDistanceField(font, size, codepoints, distanceFieldPadding);
+			else
+				result = new SpriteFont(font, size, codepoints);
+		}
+
+		// write to a uniquely named temporary file first, so a partially written cache is never loaded
+		// and other processes building the same font don't write over each other
+		var tempPath = $"{cachePath}.{Guid.NewGuid():N}.tmp";
+		try
+		{
+			Directory.CreateDirectory(cacheDirectory);
+			using (var stream = File.Create(tempPath))
+				result.Write(stream, key);
+			File.Move(tempPath, cachePath, true);
+		}
+		catch (Exception e)
+		{
+			Log.Warning($"Failed to write SpriteFont cache '{cachePath}': {e.Message}");
+			try { File.Delete(tempPath); } catch { }
+		}
+
+		return result;
+	}
+
+	/// <summary>
+	/// Reads a SpriteFont previously written with <see cref="Write(Stream)"/>
+	/// </summary>
+	public static SpriteFont Read(Stream stream)
+	{
+		if (!TryRead(stream, null, out var result))
+			throw new Exception("Invalid SpriteFont data");
+		return result;
+	}
+
+	/// <summary>
+	/// Writes the SpriteFont atlas pages, characters and kerning to a Stream, to be loaded later with <see cref="Read(Stream)"/>.
+	/// This reads the atlas pages back from the GPU, and is not supported for dynamic SpriteFonts.
+	/// </summary>
+	public void Write(Stream stream)
+		=> Write(stream, []);
+
+	private void Write(Stream stream, ReadOnlySpan<byte> key)
+	{
+		if (dynamic != null)
+			throw new InvalidOperationException("Cannot write a dynamic SpriteFont");
+
+		using var writer = new BinaryWriter(stream, Encoding.UTF8, true);
+
+		// header
+		writer.Write(CacheMagic);
+		writer.Write(CacheVersion);
+		writer.Write(key.Length);
+		writer.Write(key);
+		writer.Write(Name);
+		writer.Write(Size);
+		writer.Write(Ascent);
+		writer.Write(Descent);
+		writer.Write(LineGap);
+		writer.Write(DistanceFieldPadding);
+
+		// atlas pages as QOI images
+		writer.Write(pages.Count);
+		foreach (var page in pages)
+		{
+			var coverage = new byte[page.Width * page.Height];
+			page.GetData<byte>(coverage);
+
+			using var image = Image.FromR8(page.Width, page.Height, coverage, true);
+
+			using var encoded = new MemoryStream();
+			image.WriteQoi(encoded);
+			writer.Write((int)encoded.Length);
+			writer.Write(encoded.GetBuffer(), 0, (int)encoded.Length);
+		}
+
+		// characters
+		writer.Write(characterCount);
+		foreach (var ch in Characters)
+		{
+			writer.Write(ch.Codepoint);
+			writer.Write(ch.Advance);
+			writer.Write(ch.Offset.X);
+			writer.Write(ch.Offset.Y);
+			writer.Write(ch.Subtexture.Texture != null ? pages.IndexOf(ch.Subtexture.Texture) : -1);
+			writer.Write(ch.Subtexture.Source.X);
+			writer.Write(ch.Subtexture.Source.Y);
+			writer.Write(ch.Subtexture.Source.Width);
+			writer.Write(ch.Subtexture.Source.Height);
+			writer.Write(ch.Subtexture.Frame.X);
+			writer.Write(ch.Subtexture.Frame.Y);
+			writer.Write(ch.Subtexture.Frame.Width);
+			writer.Write(ch.Subtexture.Frame.Height);
+		}
+
+		// kerning
+		writer.Write(kerning.Count);
+		foreach (var (pair, value) in kerning)
+		{
+			writer.Write(pair.First);
+			writer.Write(pair.Second);
+			writer.Write(value);
+		}
+	}
+
+	private static bool TryRead(Stream stream, byte[]? expectedKey, out SpriteFont result)
+	{
+		result = null!;
+
+		using var reader = new BinaryReader(stream, Encoding.UTF8, true);
+
+		// header
+		Span<byte> magic = stackalloc byte[4];
+		if (reader.Read(magic) != magic.Length || !magic.SequenceEqual(CacheMagic))
+			return false;
+		if (reader.ReadInt32() != CacheVersion)
+			return false;
+
+		var key = reader.ReadBytes(reader.ReadInt32());
+		if (expectedKey != null && !key.AsSpan().SequenceEqual(expectedKey))
+			return false;
+
+		var font = new SpriteFont
+		{
+			Name = reader.ReadString(),
+			Size = reader.ReadSingle(),
+			Ascent = reader.ReadSingle(),
+			Descent = reader.ReadSingle(),
+			LineGap = reader.ReadSingle(),
+			DistanceFieldPadding = reader.ReadInt32(),
+		};
+
+		try
+		{
+			// atlas pages
+			var pageCount = reader.ReadInt32();
+			for (int i = 0; i < pageCount; i++)
+			{
+				var encoded = reader.ReadBytes(reader.ReadInt32());
+				using var image = new Image(new MemoryStream(encoded));
+				font.pages.Add(CreateCoverageTexture(image.Width, image.Height, image.Data));
+			}
+
+			// characters
+			var characterCount = reader.ReadInt32();
+			for (int i = 0; i < characterCount; i++)
+			{
+				var codepoint = reader.ReadInt32();
+				var advance = reader.ReadSingle();
+				var offset = new Vector2(reader.ReadSingle(), reader.ReadSingle());
+				var page = reader.ReadInt32();
+				var source = new Rect(reader.ReadSingle(), reader.ReadSingle(), reader.ReadSingle(), reader.ReadSingle());
+				var frame = new Rect(reader.ReadSingle(), reader.ReadSingle(), reader.ReadSingle(), reader.ReadSingle());
+				var subtexture = page >= 0 ? new Subtexture(font.pages[page], source, frame) : new Subtexture();
+				font.AddCharacter(new(codepoint, subtexture, advance, offset));
+			}
+
+			// kerning
+			var kerningCount = reader.ReadInt32();
+			for (int i = 0; i < kerningCount; i++)
+				font.SetKerning(reader.ReadInt32(), reader.ReadInt32(), reader.ReadSingle());
 		}
+		catch
+		{
+			// don't leave the pages that did load to the finalizer
+			foreach (var page in font.pages)
+				page.Dispose();
+			throw;
+		}
+
+		result = font;
+		return true;
+	}
+
+	/// <summary>
+	/// Hash of everything that affects a built SpriteFont, used to find its cache file
+	/// </summary>
+	private static byte[] GetCacheKey(ReadOnlySpan<byte> fontData, float size, ReadOnlySpan<int> codepoints, int distanceFieldPadding)
+	{
+		using var hash = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+		hash.AppendData(fontData);
+		hash.AppendData(BitConverter.GetBytes(CacheVersion));
+		hash.AppendData(BitConverter.GetBytes(size));
+		hash.AppendData(BitConverter.GetBytes(distanceFieldPadding));
+		hash.AppendData(MemoryMarshal.AsBytes(codepoints));
+		return hash.GetHashAndReset();
+	}
+
+	/// <summary>
+	/// Creates a single channel (R8) Texture from the alpha of the given pixels.
+	/// Glyphs only carry coverage, so this uses a quarter of the memory of an RGBA atlas.
+	/// The Texture is sampled as (r, r, r, r), so the Batcher draws it the same as premultiplied RGBA.
+	/// </summary>
+	private static Texture CreateCoverageTexture(int width, int height, ReadOnlySpan<Color> pixels)
+	{
+		var data = new byte[width * height];
+		PixelKernels.ToR8(pixels[..data.Length], data, ColorChannel.A);
+
+		var texture = new Texture(width, height, TextureFormat.R8);
+		texture.SetCoverage();
+		texture.SetData<byte>(data);
+		return texture;
 	}
 
 	public float WidthOf(ReadOnlySpan<char> text)
@@ -262,19 +674,68 @@ public class SpriteFont
 		);
 	}
 
-	public Character this[int codepoint] => characters[codepoint];
-	public Character this[char ch] => characters[ch];
+	public Character this[int codepoint]
+	{
+		get
+		{
+			if (!TryGetCharacter(codepoint, out var character))
+				throw new KeyNotFoundException($"SpriteFont does not contain the codepoint {codepoint}");
+			return character;
+		}
+	}
+
+	public Character this[char ch] => this[(int)ch];
+
+	/// <summary>
+	/// The number of Characters in the SpriteFont
+	/// </summary>
+	public int CharacterCount => characterCount;
+
+	/// <summary>
+	/// All the Characters in the SpriteFont, in the order they were added
+	/// </summary>
+	public ReadOnlySpan<Character> Characters => characters.AsSpan(0, characterCount);
 
 	public void AddCharacter(in Character character)
 	{
-		characters[character.Codepoint] = character;
+		var slot = GetSlot(character.Codepoint);
+		if (slot >= 0)
+		{
+			characters[slot] = character;
+			return;
+		}
+
+		if (characterCount >= characters.Length)
+			Array.Resize(ref characters, Math.Max(128, characters.Length * 2));
+
+		slot = characterCount++;
+		characters[slot] = character;
+
+		var codepoint = character.Codepoint;
+		if (codepoint >= 0 && codepoint < DenseCodepointLimit)
+		{
+			if (codepoint >= denseIndex.Length)
+				Array.Resize(ref denseIndex, Math.Min(DenseCodepointLimit, Math.Max(128, (int)BitOperations.RoundUpToPowerOf2((uint)codepoint + 1))));
+			denseIndex[codepoint] = slot + 1;
+		}
+		else
+		{
+			sparseIndex[codepoint] = slot;
+		}
+
+		// the new character may have kerning pairs that aren't in the matrix yet
+		kerningMatrix = null;
 	}
 
 	public bool TryGetCharacter(int codepoint, out Character character)
 	{
-		if (characters.TryGetValue(codepoint, out var result))
+		var slot = GetSlot(codepoint);
+		if (dynamic != null)
+			slot = dynamic.Request(this, codepoint, slot);
+
+		if (slot >= 0)
 		{
-			character = result;
+			character = characters[slot];
 			return true;
 		}
 
@@ -306,6 +767,22 @@ public class SpriteFont
 
 	public float GetKerning(int a, int b)
 	{
+		if (kerning.Count <= 0)
+			return 0;
+
+		if (kerningMatrix == null && characterCount <= MaxKerningMatrixSize)
+			BuildKerningMatrix();
+
+		// both characters are in the matrix, so it holds the answer
+		var matrix = kerningMatrix;
+		if (matrix != null)
+		{
+			var sa = GetSlot(a);
+			var sb = GetSlot(b);
+			if (sa >= 0 && sb >= 0)
+				return matrix[sa * kerningStride + sb];
+		}
+
 		if (kerning.TryGetValue(new KerningPair(a, b), out float result))
 			return result;
 		return 0;
@@ -319,5 +796,289 @@ public class SpriteFont
 	public void SetKerning(int a, int b, float value)
 	{
 		kerning[new KerningPair(a, b)] = value;
+
+		var matrix = kerningMatrix;
+		if (matrix != null)
+		{
+			var sa = GetSlot(a);
+			var sb = GetSlot(b);
+			if (sa >= 0 && sb >= 0)
+				matrix[sa * kerningStride + sb] = value;
+		}
+	}
+
+	/// <summary>
+	/// Marks the given codepoint as used this frame, so a dynamic SpriteFont doesn't evict it.
+	/// Use this when drawing previously requested characters without calling <see cref="TryGetCharacter(int, out Character)"/>.
+	/// </summary>
+	public void Touch(int codepoint)
+	{
+		var slot = GetSlot(codepoint);
+		if (dynamic != null && slot >= 0)
+			dynamic.Touch(slot);
+	}
+
+	/// <summary>
+	/// Finds the slot of the given codepoint in the characters array, or -1 if it isn't in the SpriteFont
+	/// </summary>
+	private int GetSlot(int codepoint)
+	{
+		if ((uint)codepoint < (uint)denseIndex.Length)
+			return denseIndex[codepoint] - 1;
+		if (codepoint < DenseCodepointLimit && codepoint >= 0)
+			return -1;
+		if (sparseIndex.TryGetValue(codepoint, out var slot))
+			return slot;
+		return -1;
+	}
+
+	private void BuildKerningMatrix()
+	{
+		var stride = characterCount;
+		var matrix = new float[stride * stride];
+
+		foreach (var (pair, value) in kerning)
+		{
+			var sa = GetSlot(pair.First);
+			var sb = GetSlot(pair.Second);
+			if (sa >= 0 && sb >= 0)
+				matrix[sa * stride + sb] = value;
+		}
+
+		kerningStride = stride;
+		kerningMatrix = matrix;
+	}
+
+	/// <summary>
+	/// Atlas pages used by a dynamic SpriteFont.
+	/// Characters are placed on shelves (rows of a fixed height), and a shelf is the unit of eviction.
+	/// </summary>
+	private sealed class DynamicAtlas(Font font, float scale, int pageSize, int maxPages)
+	{
+		private sealed class Shelf
+		{
+			public int Page;
+			public int Y;
+			public int Height;
+			public int X;
+			public ulong LastUsed;
+			public readonly List<int> Slots = [];
+		}
+
+		private const int Padding = 1;
+
+		public int Version;
+
+		private readonly List<Texture> pages = [];
+		private readonly List<int> pageCursors = [];
+		private readonly List<Shelf> shelves = [];
+		private Shelf?[] slotShelves = [];
+		private bool[] slotResident = [];
+		private Color[] buffer = [];
+		private byte[] coverage = [];
+
+		/// <summary>
+		/// Makes sure the given codepoint is in the SpriteFont and its pixels are in the atlas, and returns its slot
+		/// </summary>
+		public int Request(SpriteFont spriteFont, int codepoint, int slot)
+		{
+			if (slot >= 0 && slot < slotResident.Length && slotResident[slot])
+			{
+				Touch(slot);
+				return slot;
+			}
+
+			var glyph = font.GetGlyphIndex(codepoint);
+			var metrics = font.GetCharacterOfGlyph(glyph, scale);
+
+			if (slot < 0)
+			{
+				spriteFont.AddCharacter(new(codepoint, new Subtexture(), metrics.Advance, metrics.Offset));
+				slot = spriteFont.GetSlot(codepoint);
+			}
+
+			if (slot >= slotResident.Length)
+			{
+				var length = Math.Max(128, spriteFont.characters.Length);
+				Array.Resize(ref slotResident, length);
+				Array.Resize(ref slotShelves, length);
+			}
+
+			// characters without any pixels are always resident
+			if (!metrics.Visible)
+			{
+				slotResident[slot] = true;
+				return slot;
+			}
+
+			var width = metrics.Width + Padding;
+			var height = metrics.Height + Padding;
+			if (!TryAllocate(spriteFont, width, height, out var shelf))
+				return slot;
+
+			// the full cell is uploaded so the padding clears anything left by evicted characters
+			if (buffer.Length < width * height)
+				Array.Resize(ref buffer, width * height);
+			var cell = buffer.AsSpan(0, width * height);
+
+			if (font.GetPixels(metrics, buffer))
+			{
+				// GetPixels writes tightly packed rows of the glyph width, so spread them out to the cell width
+				for (int y = metrics.Height - 1; y >= 0; y--)
+				{
+					cell.Slice(y * metrics.Width, metrics.Width).CopyTo(cell.Slice(y * width, metrics.Width));
+					cell.Slice(y * width + metrics.Width, Padding).Clear();
+				}
+				cell.Slice(metrics.Height * width).Clear();
+			}
+			else
+			{
+				cell.Clear();
+			}
+
+			var texture = pages[shelf.Page];
+			if (coverage.Length < cell.Length)
+				Array.Resize(ref coverage, cell.Length);
+			PixelKernels.ToR8(cell, coverage, ColorChannel.A);
+			texture.SetData<byte>(new RectInt(shelf.X, shelf.Y, width, height), coverage.AsSpan(0, cell.Length));
+
+			var character = spriteFont.characters[slot];
+			character.Subtexture = new Subtexture(texture, new Rect(shelf.X, shelf.Y, metrics.Width, metrics.Height));
+			spriteFont.characters[slot] = character;
+
+			shelf.X += width;
+			shelf.Slots.Add(slot);
+			shelf.LastUsed = Time.Frame;
+			slotShelves[slot] = shelf;
+			slotResident[slot] = true;
+			return slot;
+		}
+
+		public void Touch(int slot)
+		{
+			if (slot < slotShelves.Length && slotShelves[slot] is Shelf shelf)
+				shelf.LastUsed = Time.Frame;
+		}
+
+		private bool TryAllocate(SpriteFont spriteFont, int width, int height, out Shelf shelf)
+		{
+			shelf = null!;
+			if (width > pageSize || height > pageSize)
+				return false;
+
+			// best fitting shelf with room left
+			Shelf? best = null;
+			foreach (var it in shelves)
+			{
+				if (it.Height >= height && it.X + width <= pageSize && (best == null || it.Height < best.Height))
+					best = it;
+			}
+
+			// don't waste tall shelves on short characters if a new shelf can be made instead
+			var shelfHeight = (height + 3) & ~3;
+			if (best != null && best.Height <= shelfHeight * 2)
+			{
+				shelf = best;
+				return true;
+			}
+
+			// new shelf on an existing page, or a new page
+			for (int i = 0; i <= pages.Count; i++)
+			{
+				if (i == pages.Count)
+				{
+					if (pages.Count >= maxPages)
+						break;
+					AddPage();
+				}
+
+				var h = Math.Min(shelfHeight, pageSize - pageCursors[i]);
+				if (h >= height)
+				{
+					shelf = new Shelf { Page = i, Y = pageCursors[i], Height = h };
+					pageCursors[i] += h;
+					shelves.Add(shelf);
+					return true;
+				}
+			}
+
+			if (best != null)
+			{
+				shelf = best;
+				return true;
+			}
+
+			// evict the least recently used shelf that's tall enough.
+			// characters used this frame may already be batched, so they're never evicted.
+			Shelf? oldest = null;
+			foreach (var it in shelves)
+			{
+				if (it.Height >= height && it.LastUsed < Time.Frame && (oldest == null || it.LastUsed < oldest.LastUsed))
+					oldest = it;
+			}
+
+			if (oldest != null)
+			{
+				Evict(spriteFont, oldest);
+				shelf = oldest;
+				return true;
+			}
+
+			// otherwise reset the least recently used page entirely
+			var page = -1;
+			var pageLastUsed = ulong.MaxValue;
+			for (int i = 0; i < pages.Count; i++)
+			{
+				var lastUsed = 0UL;
+				foreach (var it in shelves)
+					if (it.Page == i)
+						lastUsed = Math.Max(lastUsed, it.LastUsed);
+
+				if (lastUsed < Time.Frame && lastUsed < pageLastUsed)
+				{
+					page = i;
+					pageLastUsed = lastUsed;
+				}
+			}
+
+			if (page < 0)
+				return false;
+
+			foreach (var it in shelves)
+				if (it.Page == page)
+					Evict(spriteFont, it);
+			shelves.RemoveAll(it => it.Page == page);
+			pageCursors[page] = 0;
+
+			var fullHeight = Math.Min(shelfHeight, pageSize);
+			shelf = new Shelf { Page = page, Y = 0, Height = fullHeight };
+			pageCursors[page] = fullHeight;
+			shelves.Add(shelf);
+			return true;
+		}
+
+		private void AddPage()
+		{
+			// textures are created with undefined contents, so clear it
+			var page = new Texture(pageSize, pageSize, TextureFormat.R8) { Name = "SpriteFont Dynamic Atlas" };
+			page.SetCoverage();
+			page.SetData<byte>(new byte[pageSize * pageSize]);
+			pages.Add(page);
+			pageCursors.Add(0);
+		}
+
+		private void Evict(SpriteFont spriteFont, Shelf shelf)
+		{
+			foreach (var slot in shelf.Slots)
+			{
+				slotResident[slot] = false;
+				slotShelves[slot] = null;
+				spriteFont.characters[slot] = spriteFont.characters[slot] with { Subtexture = new() };
+			}
+
+			shelf.Slots.Clear();
+			shelf.X = 0;
+			Version++;
+		}
 	}
 }
@@ -42,6 +42,12 @@ public struct Subtexture
 	/// </summary>
 	public Rect Frame;
 
+	/// <summary>
+	/// If the image is stored turned 90 degrees clockwise in the Texture.
+	/// The Source rectangle is the turned area, so its width is the Height of the drawn image.
+	/// </summary>
+	public bool Rotated;
+
 	/// <summary>
 	/// The Draw Width of the Subtexture
 	/// </summary>
@@ -70,19 +76,34 @@ public struct Subtexture
 	}
 
 	public Subtexture(Texture? texture, Rect source, Rect frame)
+		: this(texture, source, frame, false)
+	{
+
+	}
+
+	/// <summary>
+	/// Creates a Subtexture whose image is stored turned 90 degrees clockwise in the Texture,
+	/// as with a <see cref="Packer.Entry"/> that is <see cref="Packer.Entry.Rotated"/>.
+	/// The Source rectangle is the turned area, so its width is the height of the drawn image.
+	/// </summary>
+	public Subtexture(Texture? texture, Rect source, Rect frame, bool rotated)
 	{
 		Texture = texture;
 		Source = source;
 		Frame = frame;
+		Rotated = rotated;
+
+		var width = rotated ? source.Height : source.Width;
+		var height = rotated ? source.Width : source.Height;
 
 		DrawCoords0.X = -frame.X;
 		DrawCoords0.Y = -frame.Y;
-		DrawCoords1.X = -frame.X + source.Width;
+		DrawCoords1.X = -frame.X + width;
 		DrawCoords1.Y = -frame.Y;
-		DrawCoords2.X = -frame.X + source.Width;
-		DrawCoords2.Y = -frame.Y + source.Height;
+		DrawCoords2.X = -frame.X + width;
+		DrawCoords2.Y = -frame.Y + height;
 		DrawCoords3.X = -frame.X;
-		DrawCoords3.Y = -frame.Y + source.Height;
+		DrawCoords3.Y = -frame.Y + height;
 
 		if (Texture != null)
 		{
@@ -94,14 +115,28 @@ public struct Subtexture
 			var tx1 = source.Right * px;
 			var ty1 = source.Bottom * py;
 
-			TexCoords0.X = tx0;
-			TexCoords0.Y = ty0;
-			TexCoords1.X = tx1;
-			TexCoords1.Y = ty0;
-			TexCoords2.X = tx1;
-			TexCoords2.Y = ty1;
-			TexCoords3.X = tx0;
-			TexCoords3.Y = ty1;
+			if (rotated)
+			{
+				TexCoords0.X = tx1;
+				TexCoords0.Y = ty0;
+				TexCoords1.X = tx1;
+				TexCoords1.Y = ty1;
+				TexCoords2.X = tx0;
+				TexCoords2.Y = ty1;
+				TexCoords3.X = tx0;
+				TexCoords3.Y = ty0;
+			}
+			else
+			{
+				TexCoords0.X = tx0;
+				TexCoords0.Y = ty0;
+				TexCoords1.X = tx1;
+				TexCoords1.Y = ty0;
+				TexCoords2.X = tx1;
+				TexCoords2.Y = ty1;
+				TexCoords3.X = tx0;
+				TexCoords3.Y = ty1;
+			}
 		}
 	}
 
@@ -109,7 +144,18 @@ public struct Subtexture
 	{
 		(Rect Source, Rect Frame) result;
 
-		result.Source = (clip + Source.Position + Frame.Position).OverlapRect(Source);
+		if (Rotated)
+		{
+			// clip the drawn image, then turn the result the same way the image is stored
+			var width = Source.Height;
+			var height = Source.Width;
+			var local = (clip + Frame.Position).OverlapRect(new Rect(0, 0, width, height));
+			result.Source = new Rect(Source.X + height - local.Bottom, Source.Y + local.X, local.Height, local.Width);
+		}
+		else
+		{
+			result.Source = (clip + Source.Position + Frame.Position).OverlapRect(Source);
+		}
 
 		result.Frame.X = MathF.Min(0, Frame.X + clip.X);
 		result.Frame.Y = MathF.Min(0, Frame.Y + clip.Y);
@@ -127,6 +173,6 @@ public struct Subtexture
 	public readonly Subtexture GetClipSubtexture(in Rect clip)
 	{
 		var (source, frame) = GetClip(clip);
-		return new Subtexture(Texture, source, frame);
+		return new Subtexture(Texture, source, frame, Rotated);
 	}
 }
@@ -0,0 +1,320 @@
+using System.Numerics;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// A string laid out against a SpriteFont once, storing glyph positions and line breaks
+/// so it can be drawn repeatedly with <see cref="Batcher.Text(TextLayout, Vector2, Color)"/>.
+/// Calling <see cref="Set(SpriteFont, ReadOnlySpan{char}, float, Vector2)"/> with unchanged values does nothing.
+/// </summary>
+public class TextLayout
+{
+	public readonly struct Glyph
+	{
+		/// <summary>
+		/// The Subtexture to draw
+		/// </summary>
+		public readonly Subtexture Subtexture;
+
+		/// <summary>
+		/// Draw position relative to the layout origin, including the character offset
+		/// </summary>
+		public readonly Vector2 Position;
+
+		/// <summary>
+		/// Index of the first char of this Glyph in the source Text
+		/// </summary>
+		public readonly int Index;
+
+		/// <summary>
+		/// Line this Glyph is on
+		/// </summary>
+		public readonly int Line;
+
+		/// <summary>
+		/// Unicode codepoint of this Glyph
+		/// </summary>
+		public readonly int Codepoint;
+
+		public Glyph(in Subtexture subtexture, in Vector2 position, int index, int line, int codepoint)
+		{
+			Subtexture = subtexture;
+			Position = position;
+			Index = index;
+			Line = line;
+			Codepoint = codepoint;
+		}
+	}
+
+	public readonly struct Line
+	{
+		/// <summary>
+		/// Index of the first char of this Line in the source Text
+		/// </summary>
+		public readonly int Start;
+
+		/// <summary>
+		/// Number of chars in this Line, not including the line break
+		/// </summary>
+		public readonly int Length;
+
+		/// <summary>
+		/// Draw position of this line relative to the layout origin
+		/// </summary>
+		public readonly Vector2 Position;
+
+		/// <summary>
+		/// Width of this line
+		/// </summary>
+		public readonly float Width;
+
+		public Line(int start, int length, in Vector2 position, float width)
+		{
+			Start = start;
+			Length = length;
+			Position = position;
+			Width = width;
+		}
+	}
+
+	/// <summary>
+	/// The Font this layout was built with
+	/// </summary>
+	public SpriteFont? Font { get; private set; }
+
+	/// <summary>
+	/// The Text this layout was built with
+	/// </summary>
+	public string Text { get; private set; } = string.Empty;
+
+	/// <summary>
+	/// Lines are wrapped to this width, preferring to break on whitespace. 0 disables wrapping.
+	/// </summary>
+	public float WrapWidth { get; private set; }
+
+	/// <summary>
+	/// Justification of the text, where (0, 0) is top-left and (1, 1) is bottom-right of the layout origin.
+	/// Each line is justified horizontally by its own width.
+	/// </summary>
+	public Vector2 Justify { get; private set; }
+
+	/// <summary>
+	/// Size of the laid out text
+	/// </summary>
+	public Vector2 Size { get; private set; }
+
+	/// <summary>
+	/// Bounds of the laid out text, relative to the layout origin
+	/// </summary>
+	public Rect Bounds { get; private set; }
+
+	/// <summary>
+	/// Visible glyphs, in text order
+	/// </summary>
+	public ReadOnlySpan<Glyph> Glyphs => glyphs.AsSpan(0, glyphCount);
+
+	/// <summary>
+	/// Lines, in text order
+	/// </summary>
+	public ReadOnlySpan<Line> Lines => lines.AsSpan(0, lineCount);
+
+	private Glyph[] glyphs = [];
+	private Line[] lines = [];
+	private int glyphCount;
+	private int lineCount;
+	private int atlasVersion;
+
+	public TextLayout()
+	{
+
+	}
+
+	public TextLayout(SpriteFont font, ReadOnlySpan<char> text, float wrapWidth = 0)
+		: this(font, text, wrapWidth, Vector2.Zero) { }
+
+	public TextLayout(SpriteFont font, ReadOnlySpan<char> text, float wrapWidth, Vector2 justify)
+	{
+		Set(font, text, wrapWidth, justify);
+	}
+
+	/// <summary>
+	/// Updates the layout. Does nothing if all the values match the current layout.
+	/// </summary>
+	public void Set(SpriteFont font, ReadOnlySpan<char> text, float wrapWidth = 0)
+		=> Set(font, text, wrapWidth, Justify);
+
+	/// <summary>
+	/// Updates the layout. Does nothing if all the values match the current layout.
+	/// </summary>
+	public void Set(SpriteFont font, ReadOnlySpan<char> text, float wrapWidth, Vector2 justify)
+	{
+		if (Font == font &&
+			WrapWidth == wrapWidth &&
+			Justify == justify &&
+			atlasVersion == font.AtlasVersion &&
+			text.SequenceEqual(Text))
+			return;
+
+		Font = font;
+		Text = text.ToString();
+		WrapWidth = wrapWidth;
+		Justify = justify;
+		Build();
+	}
+
+	/// <summary>
+	/// Rebuilds the layout from the current values.
+	/// This must be called manually if the SpriteFont's characters or kerning change.
+	/// </summary>
+	public void Build()
+	{
+		glyphCount = 0;
+		lineCount = 0;
+		Size = Vector2.Zero;
+		Bounds = new();
+
+		if (Font == null || Text.Length <= 0)
+			return;
+
+		var font = Font;
+		atlasVersion = font.AtlasVersion;
+		var text = Text.AsSpan();
+
+		// find lines and their widths
+		var width = 0.0f;
+		var start = 0;
+		while (start <= text.Length)
+		{
+			var end = FindLineEnd(font, text, start, WrapWidth, out var next, out var lineWidth);
+			AddLine(new Line(start, end - start, Vector2.Zero, lineWidth));
+			width = Math.Max(width, lineWidth);
+			start = next;
+		}
+
+		var height = lineCount * font.LineHeight - font.LineGap;
+		var top = Calc.Round(-Justify.Y * height);
+		var left = float.MaxValue;
+
+		// place the glyphs of each line
+		for (int l = 0; l < lineCount; l++)
+		{
+			var line = lines[l];
+			var at = new Vector2(
+				Calc.Round(-Justify.X * line.Width),
+				top + l * font.LineHeight);
+			lines[l] = new Line(line.Start, line.Length, at, line.Width);
+			left = Math.Min(left, at.X);
+
+			at.Y += font.Ascent;
+
+			var last = 0;
+			var end = line.Start + line.Length;
+			for (int i = line.Start; i < end; i++)
+			{
+				if (font.TryGetCharacter(text, i, out var ch, out var step))
+				{
+					if (last != 0)
+						at.X += font.GetKerning(last, ch.Codepoint);
+
+					if (ch.Subtexture.Texture != null)
+						AddGlyph(new Glyph(ch.Subtexture, at + ch.Offset, i, l, ch.Codepoint));
+
+					last = ch.Codepoint;
+					at.X += ch.Advance;
+					i += step - 1;
+				}
+			}
+		}
+
+		Size = new Vector2(width, height);
+		Bounds = new Rect(left, top, width, height);
+	}
+
+	/// <summary>
+	/// Finds the end of the line starting at the given index, and where the following line starts
+	/// </summary>
+	private static int FindLineEnd(SpriteFont font, ReadOnlySpan<char> text, int start, float wrapWidth, out int next, out float width)
+	{
+		var lineWidth = 0.0f;
+		var last = 0;
+		var breakAt = -1;
+		var breakWidth = 0.0f;
+
+		for (int i = start; i < text.Length; i++)
+		{
+			if (text[i] == '\n')
+			{
+				next = i + 1;
+				width = lineWidth;
+				return i;
+			}
+
+			if (!font.TryGetCharacter(text, i, out var ch, out var step))
+				continue;
+
+			var advance = ch.Advance;
+			if (last != 0)
+				advance += font.GetKerning(last, ch.Codepoint);
+
+			if (char.IsWhiteSpace(text[i]))
+			{
+				// whitespace never causes a wrap, but is a place a later character can wrap at
+				breakAt = i;
+				breakWidth = lineWidth;
+			}
+			else if (wrapWidth > 0 && i > start && lineWidth + advance > wrapWidth)
+			{
+				if (breakAt >= 0)
+				{
+					next = breakAt + 1;
+					width = breakWidth;
+					return breakAt;
+				}
+
+				// a single word is longer than the line, so break inside it
+				next = i;
+				width = lineWidth;
+				return i;
+			}
+
+			lineWidth += advance;
+			last = ch.Codepoint;
+			i += step - 1;
+		}
+
+		next = text.Length + 1;
+		width = lineWidth;
+		return text.Length;
+	}
+
+	/// <summary>
+	/// Makes sure the glyphs are valid to draw this frame.
+	/// For a dynamic SpriteFont this rebuilds the layout if characters were evicted since it was built,
+	/// and marks every glyph as used so none are evicted while the text is being drawn.
+	/// </summary>
+	public void Refresh()
+	{
+		if (Font == null || !Font.IsDynamic)
+			return;
+
+		if (atlasVersion != Font.AtlasVersion)
+			Build();
+
+		foreach (var glyph in Glyphs)
+			Font.Touch(glyph.Codepoint);
+	}
+
+	private void AddGlyph(in Glyph glyph)
+	{
+		if (glyphCount >= glyphs.Length)
+			Array.Resize(ref glyphs, Math.Max(16, glyphs.Length * 2));
+		glyphs[glyphCount++] = glyph;
+	}
+
+	private void AddLine(in Line line)
+	{
+		if (lineCount >= lines.Length)
+			Array.Resize(ref lines, Math.Max(4, lines.Length * 2));
+		lines[lineCount++] = line;
+	}
+}
@@ -1,4 +1,5 @@
 using System.Diagnostics;
+using System.Numerics;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 
@@ -49,6 +50,12 @@ public class Texture : IResource
 	/// </summary>
 	public int MemorySize => Width * Height * Format.Size();
 
+	/// <summary>
+	/// The number of mip levels the Texture has, including the full size level.
+	/// Mip levels are sampled when using <see cref="TextureFilter.Trilinear"/>.
+	/// </summary>
+	public int MipLevels { get; private set; } = 1;
+
 	internal readonly IntPtr resource;
 	internal bool disposed = false;
 
@@ -87,6 +94,24 @@ public class Texture : IResource
 		SetData<Color>(image.Data);
 	}
 
+	/// <summary>
+	/// Creates a Texture from the Image, optionally generating and uploading its full mip chain.
+	/// Images are assumed to be premultiplied, to match how the Batcher draws them by default.
+	/// </summary>
+	public Texture(Image image, bool generateMips, ResampleFilter mipFilter = ResampleFilter.Box, bool premultiplied = true)
+		: this(image)
+	{
+		if (generateMips)
+		{
+			var mips = image.GenerateMips(mipFilter, premultiplied);
+			for (int i = 0; i < mips.Length; i++)
+			{
+				SetMipData<Color>(i + 1, mips[i].Data);
+				mips[i].Dispose();
+			}
+		}
+	}
+
 	internal Texture(IntPtr resource, int width, int height, TextureFormat format)
 	{
 		this.resource = resource;
@@ -120,6 +145,76 @@ public class Texture : IResource
 		}
 	}
 
+	/// <summary>
+	/// Sets the Texture data of a rectangle within the Texture from the given buffer.
+	/// The buffer is tightly packed rows of the rectangle's width.
+	/// </summary>
+	public unsafe void SetData<T>(in RectInt rect, ReadOnlySpan<T> data) where T : struct
+	{
+		if (IsDisposed)
+			throw new Exception("Resource is Disposed");
+
+		if (rect.X < 0 || rect.Y < 0 || rect.Width <= 0 || rect.Height <= 0 || rect.Right > Width || rect.Bottom > Height)
+			throw new ArgumentOutOfRangeException(nameof(rect), "Rectangle must be within the bounds of the Texture");
+
+		if (Unsafe.SizeOf<T>() * data.Length < rect.Width * rect.Height * Format.Size())
+			throw new Exception("Data Buffer is smaller than the Size of the Rectangle");
+
+		fixed (byte* ptr = MemoryMarshal.AsBytes(data))
+		{
+			int length = Unsafe.SizeOf<T>() * data.Length;
+			Platform.FosterTextureSetSubData(resource, rect.X, rect.Y, rect.Width, rect.Height, ptr, length);
+		}
+	}
+
+	/// <summary>
+	/// Sets the data of a mip level from the given buffer, where level 0 is the full size Texture.
+	/// Each level is half the size of the previous, to a minimum of 1 pixel.
+	/// All levels from 1 up to the lowest one used should be set before sampling with <see cref="TextureFilter.Trilinear"/>.
+	/// </summary>
+	public unsafe void SetMipData<T>(int level, ReadOnlySpan<T> data) where T : struct
+	{
+		if (IsDisposed)
+			throw new Exception("Resource is Disposed");
+
+		if (level == 0)
+		{
+			SetData(data);
+			return;
+		}
+
+		if (level < 0 || level > BitOperations.Log2((uint)Math.Max(Width, Height)))
+			throw new ArgumentOutOfRangeException(nameof(level), "Mip level is out of range for the Texture size");
+
+		var width = Math.Max(1, Width >> level);
+		var height = Math.Max(1, Height >> level);
+
+		if (Unsafe.SizeOf<T>() * data.Length < width * height * Format.Size())
+			throw new Exception("Data Buffer is smaller than the Size of the Mip Level");
+
+		fixed (byte* ptr = MemoryMarshal.AsBytes(data))
+		{
+			int length = Unsafe.SizeOf<T>() * data.Length;
+			Platform.FosterTextureSetMipData(resource, level, ptr, length);
+		}
+
+		MipLevels = Math.Max(MipLevels, level + 1);
+	}
+
+	/// <summary>
+	/// Makes an R8 Texture sample as premultiplied white coverage (r, r, r, r) instead of (r, 0, 0, 1),
+	/// so it can be drawn by the same shaders as Color Textures. Used by SpriteFont atlases.
+	/// </summary>
+	internal void SetCoverage()
+	{
+		if (IsDisposed)
+			throw new Exception("Resource is Disposed");
+		if (Format != TextureFormat.R8)
+			throw new Exception("Only R8 Textures can be sampled as coverage");
+
+		Platform.FosterTextureSetCoverage(resource);
+	}
+
 	/// <summary>
 	/// Writes the Texture data to the given buffer
 	/// </summary>
@@ -0,0 +1,394 @@
+using System.Numerics;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// A grid of tiles drawn from a tileset of Subtextures that share a single Texture.
+/// Tiles are stored in square chunks, and each chunk is uploaded to its own static Mesh.
+/// Only chunks that have been modified are rebuilt, and only visible chunks are drawn.
+/// </summary>
+public class TileMap : IDisposable
+{
+	/// <summary>
+	/// Tile value used for cells that should not be drawn
+	/// </summary>
+	public const int Empty = -1;
+
+	/// <summary>
+	/// The largest supported chunk size, so that chunk vertices fit in 16-bit indices
+	/// </summary>
+	public const int MaxChunkSize = 128;
+
+	private class Chunk
+	{
+		public readonly int[] Tiles;
+		public Mesh? Mesh;
+		public int Quads;
+		public bool Dirty;
+
+		public Chunk(int size)
+		{
+			Tiles = new int[size * size];
+			Array.Fill(Tiles, Empty);
+		}
+	}
+
+	/// <summary>
+	/// Number of tile columns in the map
+	/// </summary>
+	public readonly int Columns;
+
+	/// <summary>
+	/// Number of tile rows in the map
+	/// </summary>
+	public readonly int Rows;
+
+	/// <summary>
+	/// Width of a single tile, in pixels
+	/// </summary>
+	public readonly int TileWidth;
+
+	/// <summary>
+	/// Height of a single tile, in pixels
+	/// </summary>
+	public readonly int TileHeight;
+
+	/// <summary>
+	/// Number of tiles along each side of a chunk
+	/// </summary>
+	public readonly int ChunkSize;
+
+	/// <summary>
+	/// Bounds of the whole map, in pixels
+	/// </summary>
+	public Rect Bounds => new(0, 0, Columns * TileWidth, Rows * TileHeight);
+
+	/// <summary>
+	/// The Material used to draw the map.
+	/// By default this uses the same Shader as the Batcher.
+	/// </summary>
+	public Material Material;
+
+	/// <summary>
+	/// Uniform names assigned on the Material when drawing
+	/// </summary>
+	public string MatrixUniform = "u_matrix";
+	public string TextureUniform = "u_texture";
+	public string SamplerUniform = "u_texture_sampler";
+
+	/// <summary>
+	/// Texture Sampler used when drawing
+	/// </summary>
+	public TextureSampler Sampler = new();
+
+	/// <summary>
+	/// Blend Mode used when drawing
+	/// </summary>
+	public BlendMode BlendMode = BlendMode.Premultiply;
+
+	/// <summary>
+	/// The tileset Texture, shared by every tile
+	/// </summary>
+	public Texture? Texture { get; private set; }
+
+	/// <summary>
+	/// Number of tiles in the tileset
+	/// </summary>
+	public int TilesetCount => tileset.Length;
+
+	/// <summary>
+	/// The number of chunks drawn in the last call to Render
+	/// </summary>
+	public int ChunksDrawn { get; private set; }
+
+	/// <summary>
+	/// The number of chunks rebuilt in the last call to Render
+	/// </summary>
+	public int ChunksRebuilt { get; private set; }
+
+	private readonly Chunk?[] chunks;
+	private readonly int chunkColumns;
+	private readonly int chunkRows;
+	private Subtexture[] tileset = [];
+	private Batcher.Vertex[] vertexBuffer = [];
+	private readonly ushort[] indexBuffer;
+
+	public TileMap(int columns, int rows, int tileWidth, int tileHeight, int chunkSize = 32)
+	{
+		if (columns <= 0 || rows <= 0)
+			throw new ArgumentException("TileMap must have at least 1 column and row");
+		if (tileWidth <= 0 || tileHeight <= 0)
+			throw new ArgumentException("TileMap tiles must have a size larger than 0");
+		if (chunkSize <= 0 || chunkSize > MaxChunkSize)
+			throw new ArgumentException($"TileMap chunk size must be between 1 and {MaxChunkSize}");
+
+		Columns = columns;
+		Rows = rows;
+		TileWidth = tileWidth;
+		TileHeight = tileHeight;
+		ChunkSize = chunkSize;
+		Material = new Material(Batcher.GetDefaultShader());
+
+		chunkColumns = (columns + chunkSize - 1) / chunkSize;
+		chunkRows = (rows + chunkSize - 1) / chunkSize;
+		chunks = new Chunk?[chunkColumns * chunkRows];
+
+		// every chunk uses the same quad index pattern, so it's built once and uploaded as needed
+		indexBuffer = new ushort[chunkSize * chunkSize * 6];
+		for (int q = 0, v = 0, i = 0; q < chunkSize * chunkSize; q++, v += 4, i += 6)
+		{
+			indexBuffer[i + 0] = (ushort)(v + 0);
+			indexBuffer[i + 1] = (ushort)(v + 1);
+			indexBuffer[i + 2] = (ushort)(v + 2);
+			indexBuffer[i + 3] = (ushort)(v + 0);
+			indexBuffer[i + 4] = (ushort)(v + 2);
+			indexBuffer[i + 5] = (ushort)(v + 3);
+		}
+	}
+
+	public TileMap(ReadOnlySpan<Subtexture> tileset, int columns, int rows, int tileWidth, int tileHeight, int chunkSize = 32)
+		: this(columns, rows, tileWidth, tileHeight, chunkSize)
+	{
+		SetTileset(tileset);
+	}
+
+	/// <summary>
+	/// Assigns the Subtextures that tile values index into.
+	/// All Subtextures must belong to the same Texture. This marks the whole map to be rebuilt.
+	/// </summary>
+	public void SetTileset(ReadOnlySpan<Subtexture> tiles)
+	{
+		Texture? texture = null;
+		foreach (var tile in tiles)
+		{
+			if (tile.Texture == null)
+				continue;
+			if (texture != null && texture != tile.Texture)
+				throw new ArgumentException("All TileMap tileset Subtextures must use the same Texture");
+			texture = tile.Texture;
+		}
+
+		tileset = tiles.ToArray();
+		Texture = texture;
+
+		foreach (var chunk in chunks)
+			if (chunk != null)
+				chunk.Dirty = true;
+	}
+
+	/// <summary>
+	/// Gets or Sets the tile at the given column and row
+	/// </summary>
+	public int this[int x, int y]
+	{
+		get => GetTile(x, y);
+		set => SetTile(x, y, value);
+	}
+
+	/// <summary>
+	/// Gets the tile at the given column and row, or Empty if out of bounds
+	/// </summary>
+	public int GetTile(int x, int y)
+	{
+		if (x < 0 || y < 0 || x >= Columns || y >= Rows)
+			return Empty;
+
+		var chunk = chunks[(x / ChunkSize) + (y / ChunkSize) * chunkColumns];
+		if (chunk == null)
+			return Empty;
+
+		return chunk.Tiles[(x % ChunkSize) + (y % ChunkSize) * ChunkSize];
+	}
+
+	/// <summary>
+	/// Sets the tile at the given column and row.
+	/// Only the chunk containing the tile is rebuilt, the next time it's drawn.
+	/// </summary>
+	public void SetTile(int x, int y, int tile)
+	{
+		if (x < 0 || y < 0 || x >= Columns || y >= Rows)
+			throw new IndexOutOfRangeException();
+
+		var chunkIndex = (x / ChunkSize) + (y / ChunkSize) * chunkColumns;
+		var chunk = chunks[chunkIndex];
+
+		if (chunk == null)
+		{
+			if (tile == Empty)
+				return;
+			chunks[chunkIndex] = chunk = new Chunk(ChunkSize);
+		}
+
+		ref var value = ref chunk.Tiles[(x % ChunkSize) + (y % ChunkSize) * ChunkSize];
+		if (value != tile)
+		{
+			value = tile;
+			chunk.Dirty = true;
+		}
+	}
+
+	/// <summary>
+	/// Sets every tile in the given rectangle
+	/// </summary>
+	public void Fill(in RectInt rect, int tile)
+	{
+		var area = rect.OverlapRect(new RectInt(0, 0, Columns, Rows));
+		for (int y = area.Top; y < area.Bottom; y++)
+			for (int x = area.Left; x < area.Right; x++)
+				SetTile(x, y, tile);
+	}
+
+	/// <summary>
+	/// Sets every tile in the map to Empty
+	/// </summary>
+	public void Clear()
+	{
+		foreach (var chunk in chunks)
+		{
+			if (chunk == null)
+				continue;
+			Array.Fill(chunk.Tiles, Empty);
+			chunk.Dirty = true;
+		}
+	}
+
+	/// <summary>
+	/// Draws the entire map
+	/// </summary>
+	public void Render(Target? target, in Matrix4x4 matrix, RectInt? viewport = null, RectInt? scissor = null)
+	{
+		Render(target, matrix, Bounds, viewport, scissor);
+	}
+
+	/// <summary>
+	/// Draws the chunks of the map that overlap the given bounds.
+	/// The bounds are in map-space pixels (ex. the camera rectangle), before the matrix is applied.
+	/// </summary>
+	public void Render(Target? target, in Matrix4x4 matrix, in Rect visible, RectInt? viewport = null, RectInt? scissor = null)
+	{
+		ChunksDrawn = 0;
+		ChunksRebuilt = 0;
+
+		if (Texture == null || Texture.IsDisposed)
+			return;
+
+		var chunkWidth = ChunkSize * TileWidth;
+		var chunkHeight = ChunkSize * TileHeight;
+		var x0 = Math.Max(0, (int)MathF.Floor(visible.Left / chunkWidth));
+		var y0 = Math.Max(0, (int)MathF.Floor(visible.Top / chunkHeight));
+		var x1 = Math.Min(chunkColumns, (int)MathF.Ceiling(visible.Right / chunkWidth));
+		var y1 = Math.Min(chunkRows, (int)MathF.Ceiling(visible.Bottom / chunkHeight));
+
+		if (x0 >= x1 || y0 >= y1)
+			return;
+
+		Material.Set(MatrixUniform, matrix);
+		Material.Set(TextureUniform, Texture);
+		Material.Set(SamplerUniform, Sampler);
+
+		for (int cy = y0; cy < y1; cy++)
+			for (int cx = x0; cx < x1; cx++)
+			{
+				var chunk = chunks[cx + cy * chunkColumns];
+				if (chunk == null)
+					continue;
+
+				if (chunk.Dirty)
+				{
+					Rebuild(chunk, cx, cy);
+					ChunksRebuilt++;
+				}
+
+				if (chunk.Quads <= 0 || chunk.Mesh == null)
+					continue;
+
+				DrawCommand command = new(target, chunk.Mesh, Material)
+				{
+					Viewport = viewport,
+					Scissor = scissor,
+					BlendMode = BlendMode,
+					MeshIndexStart = 0,
+					MeshIndexCount = chunk.Quads * 6,
+					DepthMask = false,
+					DepthCompare = DepthCompare.None,
+					CullMode = CullMode.None
+				};
+				command.Submit();
+				ChunksDrawn++;
+			}
+	}
+
+	private void Rebuild(Chunk chunk, int cx, int cy)
+	{
+		chunk.Dirty = false;
+		chunk.Quads = 0;
+
+		if (vertexBuffer.Length < chunk.Tiles.Length * 4)
+			Array.Resize(ref vertexBuffer, chunk.Tiles.Length * 4);
+
+		var mode = new Color(255, 0, 0, 0);
+		var flip = Texture != null && Texture.IsTargetAttachment && Graphics.OriginBottomLeft;
+		var originX = cx * ChunkSize;
+		var originY = cy * ChunkSize;
+		var v = 0;
+
+		for (int ty = 0; ty < ChunkSize; ty++)
+			for (int tx = 0; tx < ChunkSize; tx++)
+			{
+				var tile = chunk.Tiles[tx + ty * ChunkSize];
+				if (tile < 0 || tile >= tileset.Length)
+					continue;
+
+				ref readonly var subtex = ref tileset[tile];
+				if (subtex.Texture == null)
+					continue;
+
+				var pos = new Vector2((originX + tx) * TileWidth, (originY + ty) * TileHeight);
+				var t0 = subtex.TexCoords0;
+				var t1 = subtex.TexCoords1;
+				var t2 = subtex.TexCoords2;
+				var t3 = subtex.TexCoords3;
+
+				if (flip)
+				{
+					t0.Y = 1.0f - t0.Y;
+					t1.Y = 1.0f - t1.Y;
+					t2.Y = 1.0f - t2.Y;
+					t3.Y = 1.0f - t3.Y;
+				}
+
+				vertexBuffer[v + 0] = new(pos + subtex.DrawCoords0, t0, Color.White, mode);
+				vertexBuffer[v + 1] = new(pos + subtex.DrawCoords1, t1, Color.White, mode);
+				vertexBuffer[v + 2] = new(pos + subtex.DrawCoords2, t2, Color.White, mode);
+				vertexBuffer[v + 3] = new(pos + subtex.DrawCoords3, t3, Color.White, mode);
+				v += 4;
+				chunk.Quads++;
+			}
+
+		if (chunk.Quads <= 0)
+		{
+			chunk.Mesh?.Dispose();
+			chunk.Mesh = null;
+			return;
+		}
+
+		chunk.Mesh ??= new Mesh();
+		chunk.Mesh.SetVertices<Batcher.Vertex>(vertexBuffer.AsSpan(0, v));
+		chunk.Mesh.SetIndices<ushort>(indexBuffer.AsSpan(0, chunk.Quads * 6));
+	}
+
+	/// <summary>
+	/// Disposes of every chunk Mesh. The tile data is kept, and Meshes are recreated if drawn again.
+	/// </summary>
+	public void Dispose()
+	{
+		foreach (var chunk in chunks)
+		{
+			if (chunk?.Mesh == null)
+				continue;
+			chunk.Mesh.Dispose();
+			chunk.Mesh = null;
+			chunk.Dirty = true;
+		}
+	}
+}
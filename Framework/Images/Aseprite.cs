@@ -1,6 +1,9 @@
 using System;
+using System.Buffers;
+using System.Buffers.Binary;
 using System.IO.Compression;
 using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
 using System.Text;
 
 namespace Foster.Framework;
@@ -198,258 +201,376 @@ public class Aseprite : Aseprite.IUserDataTarget
 	
 	public Aseprite(string filePath)
 	{
-		using var file = File.OpenRead(filePath);
-		using var bin = new BinaryReader(file);
-		Load(bin);
+		// map the file instead of reading it, so its contents never touch the managed heap
+		using var mapped = new MappedFile(filePath);
+		Load(mapped.Data);
 	}
 
 	public Aseprite(BinaryReader bin)
+		: this(bin.BaseStream)
 	{
-		Load(bin);
+
 	}
 
 	public Aseprite(Stream stream)
 	{
-		using var bin = new BinaryReader(stream);
-		Load(bin);
+		// use the stream's own buffer if it's already in memory
+		if (stream is MemoryStream memory && memory.TryGetBuffer(out var buffer))
+		{
+			Load(buffer.AsSpan((int)memory.Position));
+			return;
+		}
+
+		// otherwise read the bytes into a pooled buffer
+		var length = (int)(stream.Length - stream.Position);
+		var data = ArrayPool<byte>.Shared.Rent(length);
+		try
+		{
+			stream.ReadExactly(data, 0, length);
+			Load(data.AsSpan(0, length));
+		}
+		finally
+		{
+			ArrayPool<byte>.Shared.Return(data);
+		}
 	}
-	private void Load(BinaryReader bin)
+
+	/// <summary>
+	/// Parses an Aseprite file from memory (ex. part of a pack file)
+	/// </summary>
+	public Aseprite(ReadOnlySpan<byte> data)
 	{
-		// Shorthand methods to match Aseprite's naming convention
-		byte ReadByte() => bin.ReadByte();
-		ushort ReadWord() => bin.ReadUInt16();
-		short ReadShort() => bin.ReadInt16();
-		uint ReadDWord() => bin.ReadUInt32();
-		int ReadLong() => bin.ReadInt32();
-		string ReadString() => Encoding.UTF8.GetString(bin.ReadBytes(ReadWord()));
-		void Skip(int count) => bin.BaseStream.Seek(count, SeekOrigin.Current);
-		void SkipTo(long chunkEnd) => bin.BaseStream.Seek(chunkEnd, SeekOrigin.Begin);
+		Load(data);
+	}
 
-		// Parse the file header
-		var fileSize = ReadDWord();
-		if (ReadWord() != 0xA5E0)
-			throw new Exception("Invalid Aseprite file, magic number is wrong");
-		var frameCount = ReadWord();
-		Width = ReadWord();
-		Height = ReadWord();
-		var format = (Format)ReadWord();
-		ReadDWord(); // Flags (IGNORE)
-		ReadWord(); // Speed (DEPRECATED)
-		ReadDWord(); // Set be 0
-		ReadDWord(); // Set be 0
-		ReadByte(); // Transparent Color Index
-		Skip(3);
-		ReadWord(); // Color Count
-		ReadByte(); // Pixel width
-		ReadByte(); // Pixel height
-		ReadShort(); // X position of the grid
-		ReadShort(); // Y position of the grid
-		ReadWord(); // Grid width
-		ReadWord(); // Grid height
-		Skip(84);
+	/// <summary>
+	/// Reads little-endian values from the file data, named to match Aseprite's file format spec
+	/// </summary>
+	private ref struct Reader
+	{
+		public readonly ReadOnlySpan<byte> Data;
+		public int Position;
 
-		// Create Frame array
-		Array.Resize(ref Frames, frameCount);
-		for (int i = 0; i < Frames.Length; i ++)
-			Frames[i] = new();
+		public Reader(ReadOnlySpan<byte> data)
+		{
+			Data = data;
+			Position = 0;
+		}
+
+		public byte ReadByte() => Data[Position++];
+		public ushort ReadWord() { var v = BinaryPrimitives.ReadUInt16LittleEndian(Data[Position..]); Position += 2; return v; }
+		public short ReadShort() { var v = BinaryPrimitives.ReadInt16LittleEndian(Data[Position..]); Position += 2; return v; }
+		public uint ReadDWord() { var v = BinaryPrimitives.ReadUInt32LittleEndian(Data[Position..]); Position += 4; return v; }
+		public int ReadLong() { var v = BinaryPrimitives.ReadInt32LittleEndian(Data[Position..]); Position += 4; return v; }
+		public ReadOnlySpan<byte> ReadBytes(int count) { var v = Data.Slice(Position, count); Position += count; return v; }
+		public string ReadString() => Encoding.UTF8.GetString(ReadBytes(ReadWord()));
+		public void SkipString() => Skip(ReadWord());
+		public void Skip(int count) => Position += count;
+	}
 
-		// Pixel buffer
-		var buffer = new byte[Width * Height * ((int)format / 8)];
+	private const int FileHeaderSize = 128;
+	private const int CelHeaderSize = 16;
 
-		foreach (var frame in Frames)
+	/// <summary>
+	/// Counts the pixels of every cel that has its own image, so they can all be carved from one allocation
+	/// </summary>
+	private static int CountCelPixels(ReadOnlySpan<byte> data, int frameCount)
+	{
+		var bin = new Reader(data) { Position = FileHeaderSize };
+		var total = 0;
+
+		for (int f = 0; f < frameCount; f++)
 		{
-			IUserDataTarget? userDataTarget = frame;
-			int nextTagUserData = 0;
-
-			// Parse the frame header
-			ReadDWord(); // Bytes in this frame
-			if (ReadWord() != 0xF1FA)
-				throw new Exception("Invalid Aseprite file, frame magic number is wrong");
-			
-			int oldChunkCount = ReadWord();
-			frame.Duration = ReadWord();
-			Skip(2); // For future (set to zero)
-
-			int chunkCount = (int)ReadDWord();
+			var frameStart = bin.Position;
+			var frameSize = (int)bin.ReadDWord();
+			bin.Skip(2);
+			int oldChunkCount = bin.ReadWord();
+			bin.Skip(4);
+			var chunkCount = (int)bin.ReadDWord();
 			if (chunkCount == 0)
 				chunkCount = oldChunkCount;
 
-			// Parse all the frame chunks
-			for (int ch = 0; ch < chunkCount; ++ch)
+			for (int ch = 0; ch < chunkCount; ch++)
 			{
-				var chunkStart = bin.BaseStream.Position;
-				var chunkSize = ReadDWord();
-				var chunkType = (ChunkType)ReadWord();
-				if (!Enum.IsDefined(chunkType))
-					chunkType = ChunkType.Unknown;
-				var chunkEnd = chunkStart + chunkSize;
-
-				if (chunkType == ChunkType.Palette)
-				{
-					var len = (int)ReadDWord();
-					var first = (int)ReadDWord();
-					var last = (int)ReadDWord();
-					Skip(8);
-
-					if (len > Palette.Length)
-						Array.Resize(ref Palette, len);
+				var chunkStart = bin.Position;
+				var chunkSize = (int)bin.ReadDWord();
+				var chunkType = (ChunkType)bin.ReadWord();
 
-					for (var i = first; i <= last; ++i)
-					{
-						var flags = ReadWord();
-						Palette[i] = new Color(ReadByte(), ReadByte(), ReadByte(), ReadByte());
-						if ((flags & 1) != 0)
-							ReadString();
-					}
-
-					userDataTarget = this;
-				}
-				else if (chunkType == ChunkType.Slice)
-				{
-					var count = (int)ReadDWord();
-					var flags = ReadDWord();
-					ReadDWord();
-					var name = ReadString();
-					var hasNineSlice = (flags & 1) != 0;
-					var hasPivot = (flags & 2) != 0;
-
-					var slice = new Slice(name, count);
-					Slices.Add(slice);
-					userDataTarget = slice;
-
-					for (int i = 0; i < count; ++i)
-					{
-						slice.Keys[i].FrameStart = (int)ReadDWord();
-						slice.Keys[i].Bounds = new RectInt(ReadLong(), ReadLong(), (int)ReadDWord(), (int)ReadDWord());
-						if (hasNineSlice)
-							slice.Keys[i].NinSliceCenters = new RectInt(ReadLong(), ReadLong(), (int)ReadDWord(), (int)ReadDWord());
-						if (hasPivot)
-							slice.Keys[i].Pivot = new Point2(ReadLong(), ReadLong());
-					}
-				}
-				else if (chunkType == ChunkType.Tags)
+				if (chunkType == ChunkType.Cel)
 				{
-					Array.Resize(ref Tags, ReadWord());
-					Skip(8);
-					for (int t = 0; t < Tags.Length; ++t)
+					bin.Skip(7);
+					var type = (CelType)bin.ReadWord();
+					if (type == CelType.RawImageData || type == CelType.CompressedImage)
 					{
-						var tag = Tags[t] = new Tag();
-						tag.From = ReadWord();
-						tag.To = ReadWord();
-						tag.LoopDir = (LoopDir)ReadByte();
-						tag.Repeat = ReadWord();
-						Skip(10);
-						tag.Name = ReadString();
+						bin.Position = chunkStart + CelHeaderSize + 6;
+						total += bin.ReadWord() * bin.ReadWord();
 					}
-					userDataTarget = null;
 				}
-				else if (chunkType == ChunkType.UserData)
-				{
-					var text = string.Empty;
-					var color = Color.Transparent;
-					var flags = ReadDWord();
-					if ((flags & 1) != 0)
-						text = ReadString();
-					if ((flags & 2) != 0)
-						color = new Color(ReadByte(), ReadByte(), ReadByte(), ReadByte());
-
-					if (userDataTarget is IUserDataTarget target)
-					{
-						target.UserData = new(text, color);
-						userDataTarget = null;
-					}
-					else if (nextTagUserData < Tags.Length)
-					{
-						Tags[nextTagUserData++].UserData = new(text, color);
-					}
-				}
-				else if (chunkType == ChunkType.Layer)
-				{
-					var layer = new Layer();
-					Layers.Add(layer);
-					userDataTarget = layer;
-
-					layer.Flags = (LayerFlags)ReadWord();
-					layer.Type = (LayerType)ReadWord();
-					layer.ChildLevel = ReadWord();
-					layer.DefaultSize = new Point2(ReadWord(), ReadWord());
-					layer.BlendMode = (BlendMode)ReadWord();
-					layer.Opacity = ReadByte();
-					Skip(3);
-					layer.Name = ReadString();
-					if (layer.Type == LayerType.Tilemap)
-						layer.TilesetIndex = (int)ReadDWord();
-				}
-				else if (chunkType == ChunkType.Cel)
-				{
-					var layer = Layers[ReadWord()];
-					var pos = new Point2(ReadShort(), ReadShort());
-					var opacity = ReadByte();
-					var type = (CelType)ReadWord();
-					var zIndex = ReadShort();
-
-					// Compressed Tilemap not supported
-					if (type == CelType.CompressedTilemap)
-					{
-						Log.Warning("Aseprite Tilemaps are not supported");
-						SkipTo(chunkEnd);
-						continue;
-					}
 
-					var cel = new Cel(layer, pos, opacity, zIndex);
-					frame.Cels.Add(cel);
-					userDataTarget = cel;
+				bin.Position = chunkStart + chunkSize;
+			}
 
-					Skip(5);
+			bin.Position = frameStart + frameSize;
+		}
 
-					// references an existing Cel instead of containing its own data
-					if (type == CelType.LinkedCel)
-					{
-						var linkedFrame = ReadWord();
-						var linkedCel = Frames[linkedFrame].Cels.Find(c => c.Layer == layer)!;
-						cel.Image = linkedCel.Image;
-						SkipTo(chunkEnd);
-						continue;
-					}
+		return total;
+	}
 
-					var width = (int)ReadWord();
-					var height = (int)ReadWord();
-					var pixels = new Color[width * height];
-					var decompressedLen = width * height * ((int)format / 8);
+	private unsafe void Load(ReadOnlySpan<byte> data)
+	{
+		var bin = new Reader(data);
 
-					if (buffer.Length < decompressedLen)
-						Array.Resize(ref buffer, decompressedLen);
+		// Parse the file header
+		bin.ReadDWord(); // File size
+		if (bin.ReadWord() != 0xA5E0)
+			throw new Exception("Invalid Aseprite file, magic number is wrong");
+		var frameCount = bin.ReadWord();
+		Width = bin.ReadWord();
+		Height = bin.ReadWord();
+		var format = (Format)bin.ReadWord();
+		bin.ReadDWord(); // Flags (IGNORE)
+		bin.ReadWord(); // Speed (DEPRECATED)
+		bin.ReadDWord(); // Set be 0
+		bin.ReadDWord(); // Set be 0
+		bin.ReadByte(); // Transparent Color Index
+		bin.Skip(3);
+		bin.ReadWord(); // Color Count
+		bin.ReadByte(); // Pixel width
+		bin.ReadByte(); // Pixel height
+		bin.ReadShort(); // X position of the grid
+		bin.ReadShort(); // Y position of the grid
+		bin.ReadWord(); // Grid width
+		bin.ReadWord(); // Grid height
+		bin.Skip(84);
 
-					if (type == CelType.RawImageData)
-					{
-						bin.Read(buffer, 0, decompressedLen);
-					}
-					else if (type == CelType.CompressedImage)
-					{
-						using var zip = new ZLibStream(bin.BaseStream, CompressionMode.Decompress, true);
-						zip.ReadExactly(buffer, 0, decompressedLen);
-					}
+		// Create Frame array
+		Array.Resize(ref Frames, frameCount);
+		for (int i = 0; i < Frames.Length; i ++)
+			Frames[i] = new();
+
+		// Every cel image is a slice of one pinned array, rather than an allocation each
+		var arena = GC.AllocateUninitializedArray<Color>(CountCelPixels(data, frameCount), pinned: true);
+		var arenaIndex = 0;
+
+		// Grayscale and Indexed pixels are decompressed to a pooled buffer and then converted.
+		// RGBA pixels are already laid out like Colors, so they're decompressed straight into the arena.
+		var bytesPerPixel = (int)format / 8;
+		var buffer = format != Format.Rgba ? ArrayPool<byte>.Shared.Rent(Width * Height * bytesPerPixel) : [];
+		var palette = format == Format.Indexed ? new Color[256] : [];
+
+		fixed (byte* pointer = data)
+		{
+			// compressed cels are read through a stream over the file data, which never copies it
+			using var memory = new UnmanagedMemoryStream(pointer, data.Length);
+
+			try
+			{
+				foreach (var frame in Frames)
+				{
+					IUserDataTarget? userDataTarget = frame;
+					int nextTagUserData = 0;
+
+					// Parse the frame header
+					var frameStart = bin.Position;
+					var frameSize = (int)bin.ReadDWord(); // Bytes in this frame
+					if (bin.ReadWord() != 0xF1FA)
+						throw new Exception("Invalid Aseprite file, frame magic number is wrong");
+
+					int oldChunkCount = bin.ReadWord();
+					frame.Duration = bin.ReadWord();
+					bin.Skip(2); // For future (set to zero)
 
-					switch (format)
+					int chunkCount = (int)bin.ReadDWord();
+					if (chunkCount == 0)
+						chunkCount = oldChunkCount;
+
+					// Parse all the frame chunks
+					for (int ch = 0; ch < chunkCount; ++ch)
 					{
-						case Format.Rgba:
-							for (int i = 0, b = 0; i < pixels.Length; ++i, b += 4)
-								pixels[i] = new Color(buffer[b], buffer[b + 1], buffer[b + 2], buffer[b + 3]);
-							break;
-						case Format.Grayscale:
-							for (int i = 0, b = 0; i < pixels.Length; ++i, b += 2)
-								pixels[i] = new Color(buffer[b], buffer[b], buffer[b], buffer[b + 1]);
-							break;
-						case Format.Indexed:
-							for (int i = 0; i < pixels.Length; ++i)
-								pixels[i] = Palette[buffer[i]];
-							break;
+						var chunkStart = bin.Position;
+						var chunkSize = bin.ReadDWord();
+						var chunkType = (ChunkType)bin.ReadWord();
+						if (!Enum.IsDefined(chunkType))
+							chunkType = ChunkType.Unknown;
+						var chunkEnd = chunkStart + (int)chunkSize;
+
+						if (chunkType == ChunkType.Palette)
+						{
+							var len = (int)bin.ReadDWord();
+							var first = (int)bin.ReadDWord();
+							var last = (int)bin.ReadDWord();
+							bin.Skip(8);
+
+							if (len > Palette.Length)
+								Array.Resize(ref Palette, len);
+
+							for (var i = first; i <= last; ++i)
+							{
+								var flags = bin.ReadWord();
+								Palette[i] = new Color(bin.ReadByte(), bin.ReadByte(), bin.ReadByte(), bin.ReadByte());
+								if ((flags & 1) != 0)
+									bin.SkipString();
+							}
+
+							Palette.AsSpan(0, Math.Min(Palette.Length, palette.Length)).CopyTo(palette);
+							userDataTarget = this;
+						}
+						else if (chunkType == ChunkType.Slice)
+						{
+							var count = (int)bin.ReadDWord();
+							var flags = bin.ReadDWord();
+							bin.ReadDWord();
+							var name = bin.ReadString();
+							var hasNineSlice = (flags & 1) != 0;
+							var hasPivot = (flags & 2) != 0;
+
+							var slice = new Slice(name, count);
+							Slices.Add(slice);
+							userDataTarget = slice;
+
+							for (int i = 0; i < count; ++i)
+							{
+								slice.Keys[i].FrameStart = (int)bin.ReadDWord();
+								slice.Keys[i].Bounds = new RectInt(bin.ReadLong(), bin.ReadLong(), (int)bin.ReadDWord(), (int)bin.ReadDWord());
+								if (hasNineSlice)
+									slice.Keys[i].NinSliceCenters = new RectInt(bin.ReadLong(), bin.ReadLong(), (int)bin.ReadDWord(), (int)bin.ReadDWord());
+								if (hasPivot)
+									slice.Keys[i].Pivot = new Point2(bin.ReadLong(), bin.ReadLong());
+							}
+						}
+						else if (chunkType == ChunkType.Tags)
+						{
+							Array.Resize(ref Tags, bin.ReadWord());
+							bin.Skip(8);
+							for (int t = 0; t < Tags.Length; ++t)
+							{
+								var tag = Tags[t] = new Tag();
+								tag.From = bin.ReadWord();
+								tag.To = bin.ReadWord();
+								tag.LoopDir = (LoopDir)bin.ReadByte();
+								tag.Repeat = bin.ReadWord();
+								bin.Skip(10);
+								tag.Name = bin.ReadString();
+							}
+							userDataTarget = null;
+						}
+						else if (chunkType == ChunkType.UserData)
+						{
+							var text = string.Empty;
+							var color = Color.Transparent;
+							var flags = bin.ReadDWord();
+							if ((flags & 1) != 0)
+								text = bin.ReadString();
+							if ((flags & 2) != 0)
+								color = new Color(bin.ReadByte(), bin.ReadByte(), bin.ReadByte(), bin.ReadByte());
+
+							if (userDataTarget is IUserDataTarget target)
+							{
+								target.UserData = new(text, color);
+								userDataTarget = null;
+							}
+							else if (nextTagUserData < Tags.Length)
+							{
+								Tags[nextTagUserData++].UserData = new(text, color);
+							}
+						}
+						else if (chunkType == ChunkType.Layer)
+						{
+							var layer = new Layer();
+							Layers.Add(layer);
+							userDataTarget = layer;
+
+							layer.Flags = (LayerFlags)bin.ReadWord();
+							layer.Type = (LayerType)bin.ReadWord();
+							layer.ChildLevel = bin.ReadWord();
+							layer.DefaultSize = new Point2(bin.ReadWord(), bin.ReadWord());
+							layer.BlendMode = (BlendMode)bin.ReadWord();
+							layer.Opacity = bin.ReadByte();
+							bin.Skip(3);
+							layer.Name = bin.ReadString();
+							if (layer.Type == LayerType.Tilemap)
+								layer.TilesetIndex = (int)bin.ReadDWord();
+						}
+						else if (chunkType == ChunkType.Cel)
+						{
+							var layer = Layers[bin.ReadWord()];
+							var pos = new Point2(bin.ReadShort(), bin.ReadShort());
+							var opacity = bin.ReadByte();
+							var type = (CelType)bin.ReadWord();
+							var zIndex = bin.ReadShort();
+
+							// Compressed Tilemap not supported
+							if (type == CelType.CompressedTilemap)
+							{
+								Log.Warning("Aseprite Tilemaps are not supported");
+								bin.Position = chunkEnd;
+								continue;
+							}
+
+							var cel = new Cel(layer, pos, opacity, zIndex);
+							frame.Cels.Add(cel);
+							userDataTarget = cel;
+
+							bin.Skip(5);
+
+							// references an existing Cel instead of containing its own data
+							if (type == CelType.LinkedCel)
+							{
+								var linkedFrame = bin.ReadWord();
+								var linkedCel = Frames[linkedFrame].Cels.Find(c => c.Layer == layer)!;
+								cel.Image = linkedCel.Image;
+								bin.Position = chunkEnd;
+								continue;
+							}
+
+							var width = (int)bin.ReadWord();
+							var height = (int)bin.ReadWord();
+							var pixels = arena.AsSpan(arenaIndex, width * height);
+							var decompressedLen = width * height * bytesPerPixel;
+
+							if (format != Format.Rgba && buffer.Length < decompressedLen)
+							{
+								ArrayPool<byte>.Shared.Return(buffer);
+								buffer = ArrayPool<byte>.Shared.Rent(decompressedLen);
+							}
+
+							var bytes = format == Format.Rgba ? MemoryMarshal.AsBytes(pixels) : buffer.AsSpan(0, decompressedLen);
+
+							if (type == CelType.RawImageData)
+							{
+								bin.ReadBytes(decompressedLen).CopyTo(bytes);
+							}
+							else if (type == CelType.CompressedImage)
+							{
+								memory.Position = bin.Position;
+								using var zip = new ZLibStream(memory, CompressionMode.Decompress, true);
+								zip.ReadExactly(bytes);
+							}
+
+							switch (format)
+							{
+								case Format.Grayscale:
+									PixelKernels.FromGrayscaleAlpha(bytes, pixels);
+									break;
+								case Format.Indexed:
+									PixelKernels.FromIndexed(bytes, palette, pixels);
+									break;
+							}
+
+							cel.Image = new Image(width, height, arena, arenaIndex);
+							arenaIndex += pixels.Length;
+						}
+
+						bin.Position = chunkEnd;
 					}
 
-					cel.Image = new Image(width, height, pixels);
+					bin.Position = frameStart + frameSize;
 				}
-
-				SkipTo(chunkEnd);
+			}
+			finally
+			{
+				if (buffer.Length > 0)
+					ArrayPool<byte>.Shared.Return(buffer);
 			}
 		}
 	}
@@ -459,23 +580,9 @@ public class Aseprite : Aseprite.IUserDataTarget
 	/// </summary>
 	public Image RenderFrame(int index, Predicate<Layer>? layerFilter = null)
 	{
+		var plan = new RenderPlan(this, index, index, layerFilter, visibleOnly: true);
 		var image = new Image(Width, Height);
-
-		foreach (var layer in Layers)
-		{
-			if (!layer.Visible)
-				continue;
-			if (layerFilter != null && !layerFilter(layer))
-				continue;
-			if (Frames[index].Cels.Find(cel => cel.Layer == layer) is not Cel cel)
-				continue;
-			if (cel.Image is not Image src)
-				continue;
-
-			int opacity = MulUn8(cel.Opacity, layer.Opacity);
-			image.CopyPixels(src, src.Bounds, cel.Pos, (src, dst) => BlendNormal(dst, src, opacity));
-		}
-
+		Composite(plan, 0, image, Point2.Zero);
 		return image;
 	}
 
@@ -485,30 +592,8 @@ public class Aseprite : Aseprite.IUserDataTarget
 	/// </summary>
 	public Image[] RenderFrames(int from, int to, Predicate<Layer>? layerFilter = null)
 	{
-		var len = (to - from) + 1;
-		var results = new Image[len];
-		for (int i = 0; i < len; i ++)
-			results[i] = new Image(Width, Height);
-
-		foreach (var layer in Layers)
-		{
-			if (!layer.Visible)
-				continue;
-			if (layerFilter != null && !layerFilter(layer))
-				continue;
-			for (int i = 0; i < len; ++i)
-			{
-				if (Frames[from + i].Cels.Find(cel => cel.Layer == layer) is not Cel cel)
-					continue;
-				if (cel.Image is not Image src)
-					continue;
-
-				int opacity = MulUn8(cel.Opacity, layer.Opacity);
-				results[i].CopyPixels(src, src.Bounds, cel.Pos, (src, dst) => BlendNormal(dst, src, opacity));
-			}
-		}
-
-		return results;
+		var plan = new RenderPlan(this, from, to, layerFilter, visibleOnly: true);
+		return RenderFrames(plan, Width, Height, Point2.Zero);
 	}
 
 	/// <summary>
@@ -517,35 +602,8 @@ public class Aseprite : Aseprite.IUserDataTarget
 	/// </summary>
 	public Image[] RenderFrames(int from, int to, in RectInt slice, Predicate<Layer> layerFilter)
 	{
-		var len = (to - from) + 1;
-		var results = new Image[Frames.Length];
-		for (int i = 0; i < results.Length; i ++)
-			results[i] = new Image(slice.Width, slice.Height);
-
-		foreach (var layer in Layers)
-		{
-			if (!layerFilter(layer))
-				continue;
-
-			if (layer.BlendMode != BlendMode.Normal)
-				Log.Warning("Aseprite BlendModes are not supported; Falling back to Normal");
-
-			for (int i = from; i < len; ++i)
-			{
-				if (Frames[i].Cels.Find(cel => cel.Layer == layer) is not Cel cel)
-					continue;
-				if (cel.Image is not Image src)
-					continue;
-				if (!slice.Overlaps(new RectInt(cel.Pos.X, cel.Pos.Y, src.Width, src.Height)))
-					continue;
-
-				// TODO: handle group layer opacity cascading
-				int opacity = MulUn8(cel.Opacity, layer.Opacity);
-				results[i].CopyPixels(src, cel.Pos - slice.TopLeft, (src, dst) => BlendNormal(dst, src, opacity));
-			}
-		}
-
-		return results;
+		var plan = new RenderPlan(this, from, to, layerFilter, visibleOnly: false);
+		return RenderFrames(plan, slice.Width, slice.Height, slice.TopLeft);
 	}
 
 	/// <summary>
@@ -558,42 +616,155 @@ public class Aseprite : Aseprite.IUserDataTarget
 		return RenderFrames(0, Frames.Length - 1, layerFilter);
 	}
 
-	[MethodImpl(MethodImplOptions.AggressiveInlining | MethodImplOptions.AggressiveOptimization)]
-	private static int MulUn8(int a, int b)
+	/// <summary>
+	/// The layers to draw and their cels for a range of frames, so rendering doesn't have to search for them
+	/// </summary>
+	private sealed class RenderPlan
 	{
-		var t = a * b + 0x80;
-		return (t >> 8) + t >> 8;
+		public readonly int FrameCount;
+		public readonly List<Layer> Layers = [];
+		public readonly List<int> LayerIndices = [];
+		public readonly List<int> Opacities = [];
+		public readonly Cel?[] Cels;
+
+		public RenderPlan(Aseprite ase, int from, int to, Predicate<Layer>? layerFilter, bool visibleOnly)
+		{
+			if (from < 0 || to >= ase.Frames.Length || to < from)
+				throw new ArgumentOutOfRangeException(nameof(from), "Invalid Aseprite frame range");
+
+			// groups pass their opacity and visibility down to each of their children
+			var depth = ase.Layers.Count + 1;
+			Span<int> groupOpacity = depth <= 64 ? stackalloc int[depth] : new int[depth];
+			Span<bool> groupVisible = depth <= 64 ? stackalloc bool[depth] : new bool[depth];
+			groupOpacity[0] = 255;
+			groupVisible[0] = true;
+
+			var lookup = new Dictionary<Layer, int>();
+			for (int i = 0; i < ase.Layers.Count; i++)
+			{
+				var layer = ase.Layers[i];
+				var level = Math.Clamp(layer.ChildLevel, 0, depth - 2);
+				var opacity = MulUn8(groupOpacity[level], layer.Opacity);
+				var visible = groupVisible[level] && layer.Visible;
+
+				if (layer.Type == LayerType.Group)
+				{
+					groupOpacity[level + 1] = opacity;
+					groupVisible[level + 1] = visible;
+					continue;
+				}
+
+				if (visibleOnly && !visible)
+					continue;
+				if (layerFilter != null && !layerFilter(layer))
+					continue;
+
+				lookup[layer] = Layers.Count;
+				Layers.Add(layer);
+				LayerIndices.Add(i);
+				Opacities.Add(opacity);
+			}
+
+			FrameCount = to - from + 1;
+			Cels = new Cel?[FrameCount * Layers.Count];
+			for (int i = 0; i < FrameCount; i++)
+			{
+				foreach (var cel in ase.Frames[from + i].Cels)
+				{
+					if (cel.Image != null && lookup.TryGetValue(cel.Layer, out var index))
+						Cels[i * Layers.Count + index] = cel;
+				}
+			}
+		}
 	}
 
-	[MethodImpl(MethodImplOptions.AggressiveInlining | MethodImplOptions.AggressiveOptimization)]
-	private static Color BlendNormal(Color backdrop, Color src, int opacity)
+	private static Image[] RenderFrames(RenderPlan plan, int width, int height, Point2 origin)
 	{
-		int r, g, b, a;
+		var results = new Image[plan.FrameCount];
 
-		if (backdrop.A == 0)
+		// each frame is drawn into its own image, so they're independent
+		if (plan.FrameCount > 1)
 		{
-			r = src.R;
-			g = src.G;
-			b = src.B;
+			Parallel.For(0, plan.FrameCount, i =>
+			{
+				results[i] = new Image(width, height);
+				Composite(plan, i, results[i], origin);
+			});
 		}
-		else if (src.A == 0)
+		else
 		{
-			r = backdrop.R;
-			g = backdrop.G;
-			b = backdrop.B;
+			results[0] = new Image(width, height);
+			Composite(plan, 0, results[0], origin);
 		}
-		else
+
+		return results;
+	}
+
+	/// <summary>
+	/// Draws each cel of the frame onto the image, from the bottom layer up.
+	/// A cel's Z-Index moves it up or down by that many layers, and cels that land
+	/// on the same layer are ordered by their Z-Index.
+	/// </summary>
+	private static void Composite(RenderPlan plan, int frame, Image image, Point2 origin)
+	{
+		var count = plan.Layers.Count;
+		var cels = plan.Cels.AsSpan(frame * count, count);
+		Span<int> order = count <= 256 ? stackalloc int[count] : new int[count];
+		var drawn = 0;
+		var reorder = false;
+
+		for (int i = 0; i < count; i++)
 		{
-			r = backdrop.R + MulUn8(src.R - backdrop.R, opacity);
-			g = backdrop.G + MulUn8(src.G - backdrop.G, opacity);
-			b = backdrop.B + MulUn8(src.B - backdrop.B, opacity);
+			if (cels[i] is not Cel cel)
+				continue;
+			order[drawn++] = i;
+			reorder |= cel.ZIndex != 0;
 		}
 
-		a = backdrop.A + MulUn8(Math.Max(0, src.A - backdrop.A), opacity);
-		if (a == 0)
-			r = g = b = 0;
+		if (reorder)
+		{
+			var celsArray = plan.Cels;
+			var offset = frame * count;
+			order[..drawn].Sort((a, b) =>
+			{
+				int za = celsArray[offset + a]!.ZIndex, zb = celsArray[offset + b]!.ZIndex;
+				int oa = plan.LayerIndices[a] + za, ob = plan.LayerIndices[b] + zb;
+				return oa != ob ? oa.CompareTo(ob) : za != zb ? za.CompareTo(zb) : a.CompareTo(b);
+			});
+		}
+
+		var dst = image.Data;
+		foreach (var i in order[..drawn])
+		{
+			var cel = cels[i]!;
+			var src = cel.Image!;
+			var opacity = MulUn8(cel.Opacity, plan.Opacities[i]);
+			if (opacity <= 0)
+				continue;
+
+			var pos = cel.Pos - origin;
+			var rect = new RectInt(pos.X, pos.Y, src.Width, src.Height).OverlapRect(image.Bounds);
+			if (rect.Width <= 0 || rect.Height <= 0)
+				continue;
 
-		return new Color((byte)r, (byte)g, (byte)b, (byte)a);
+			var from = rect.TopLeft - pos;
+			var pixels = src.Data;
+			var mode = plan.Layers[i].BlendMode;
+			for (int y = 0; y < rect.Height; y++)
+			{
+				AsepriteBlend.Blend(
+					pixels.Slice(from.X + (from.Y + y) * src.Width, rect.Width),
+					dst.Slice(rect.X + (rect.Y + y) * image.Width, rect.Width),
+					mode, opacity);
+			}
+		}
+	}
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining | MethodImplOptions.AggressiveOptimization)]
+	private static int MulUn8(int a, int b)
+	{
+		var t = a * b + 0x80;
+		return (t >> 8) + t >> 8;
 	}
 }
 
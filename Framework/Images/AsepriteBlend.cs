@@ -0,0 +1,510 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Runtime.Intrinsics;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// Aseprite's layer blend modes, over straight (non-premultiplied) alpha pixels.
+/// Each mode mixes the source color with the backdrop color, and the result is then
+/// composited over the backdrop with the source alpha, the same way Aseprite does.
+/// Colors are processed 8 at a time, and the scalar path gives identical results.
+/// </summary>
+internal static class AsepriteBlend
+{
+	private static Vector256<int> ByteMask => Vector256.Create(0xFF);
+	private static Vector256<int> Max => Vector256.Create(255);
+
+	/// <summary>
+	/// round(a * b / 255)
+	/// </summary>
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<int> Mul(Vector256<int> a, Vector256<int> b)
+	{
+		var t = a * b + Vector256.Create(0x80);
+		return ((t >> 8) + t) >> 8;
+	}
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static int Mul(int a, int b)
+	{
+		var t = a * b + 0x80;
+		return ((t >> 8) + t) >> 8;
+	}
+
+	/// <summary>
+	/// round(a * 255 / b). Float division is exact enough for these ranges to truncate the same as integer division.
+	/// </summary>
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<int> Div(Vector256<int> a, Vector256<int> b)
+		=> Vector256.ConvertToInt32(Vector256.ConvertToSingle(a * Max + (b >> 1)) / Vector256.ConvertToSingle(b));
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static int Div(int a, int b)
+		=> (int)((float)(a * 255 + (b >> 1)) / b);
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<int> Select(Vector256<int> condition, Vector256<int> whenTrue, Vector256<int> whenFalse)
+		=> Vector256.ConditionalSelect(condition, whenTrue, whenFalse);
+
+	/// <summary>
+	/// Blends the source pixels onto the backdrop pixels, with the opacity applied to the source
+	/// </summary>
+	public static void Blend(ReadOnlySpan<Color> source, Span<Color> backdrop, Aseprite.BlendMode mode, int opacity)
+	{
+		switch (mode)
+		{
+			case Aseprite.BlendMode.Normal: Blend<NormalMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Multiply: Blend<MultiplyMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Screen: Blend<ScreenMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Overlay: Blend<OverlayMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Darken: Blend<DarkenMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Lighten: Blend<LightenMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.ColorDodge: Blend<ColorDodgeMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.ColorBurn: Blend<ColorBurnMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.HardLight: Blend<HardLightMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.SoftLight: Blend<SoftLightMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Difference: Blend<DifferenceMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Exclusion: Blend<ExclusionMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Hue: Blend<HueMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Saturation: Blend<SaturationMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Color: Blend<ColorMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Luminosity: Blend<LuminosityMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Addition: Blend<AdditionMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Subtract: Blend<SubtractMode>(source, backdrop, opacity); break;
+			case Aseprite.BlendMode.Divide: Blend<DivideMode>(source, backdrop, opacity); break;
+			default: Blend<NormalMode>(source, backdrop, opacity); break;
+		}
+	}
+
+	/// <summary>
+	/// Tags each blend mode with its own type, so the loop below is compiled once per mode
+	/// with the mode as a constant, and the unused branches are removed.
+	/// </summary>
+	private interface IMode { static abstract Aseprite.BlendMode Mode { get; } }
+	private struct NormalMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Normal; }
+	private struct MultiplyMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Multiply; }
+	private struct ScreenMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Screen; }
+	private struct OverlayMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Overlay; }
+	private struct DarkenMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Darken; }
+	private struct LightenMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Lighten; }
+	private struct ColorDodgeMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.ColorDodge; }
+	private struct ColorBurnMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.ColorBurn; }
+	private struct HardLightMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.HardLight; }
+	private struct SoftLightMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.SoftLight; }
+	private struct DifferenceMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Difference; }
+	private struct ExclusionMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Exclusion; }
+	private struct HueMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Hue; }
+	private struct SaturationMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Saturation; }
+	private struct ColorMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Color; }
+	private struct LuminosityMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Luminosity; }
+	private struct AdditionMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Addition; }
+	private struct SubtractMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Subtract; }
+	private struct DivideMode : IMode { public static Aseprite.BlendMode Mode => Aseprite.BlendMode.Divide; }
+
+	[MethodImpl(MethodImplOptions.AggressiveOptimization)]
+	private static void Blend<T>(ReadOnlySpan<Color> source, Span<Color> backdrop, int opacity) where T : struct, IMode
+	{
+		var mode = T.Mode;
+		var src = MemoryMarshal.Cast<Color, int>(source);
+		var dst = MemoryMarshal.Cast<Color, int>(backdrop);
+		var i = 0;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			var o = Vector256.Create(opacity);
+
+			for (; i + 8 <= src.Length; i += 8)
+			{
+				var s = Vector256.LoadUnsafe(ref MemoryMarshal.GetReference(src), (nuint)i);
+				var d = Vector256.LoadUnsafe(ref MemoryMarshal.GetReference(dst), (nuint)i);
+
+				var sa = (s >> 24) & ByteMask;
+				if (sa == Vector256<int>.Zero)
+					continue;
+
+				// opaque pixels on a normal layer simply replace the backdrop
+				var a = Mul(sa, o);
+				var opaque = Vector256.EqualsAll(a, Max);
+				if (opaque && mode == Aseprite.BlendMode.Normal)
+				{
+					s.StoreUnsafe(ref MemoryMarshal.GetReference(dst), (nuint)i);
+					continue;
+				}
+
+				var sr = s & ByteMask;
+				var sg = (s >> 8) & ByteMask;
+				var sb = (s >> 16) & ByteMask;
+				var br = d & ByteMask;
+				var bg = (d >> 8) & ByteMask;
+				var bb = (d >> 16) & ByteMask;
+				var ba = (d >> 24) & ByteMask;
+
+				Vector256<int> r, g, b;
+				switch (mode)
+				{
+					case Aseprite.BlendMode.Hue:
+					case Aseprite.BlendMode.Saturation:
+					case Aseprite.BlendMode.Color:
+					case Aseprite.BlendMode.Luminosity:
+						BlendHsl(mode, br, bg, bb, sr, sg, sb, out r, out g, out b);
+						break;
+					default:
+						r = BlendChannel(mode, br, sr);
+						g = BlendChannel(mode, bg, sg);
+						b = BlendChannel(mode, bb, sb);
+						break;
+				}
+
+				// composite the blended color over the backdrop: Ra = Sa + Ba * (1 - Sa), R = B + (S - B) * Sa / Ra
+				Vector256<int> result;
+				if (opaque)
+				{
+					result = r | (g << 8) | (b << 16) | (Max << 24);
+				}
+				else
+				{
+					var ra = a + ba - Mul(ba, a);
+					var div = Vector256.ConvertToSingle(Vector256.Max(ra, Vector256<int>.One));
+					r = br + Vector256.ConvertToInt32(Vector256.ConvertToSingle((r - br) * a) / div);
+					g = bg + Vector256.ConvertToInt32(Vector256.ConvertToSingle((g - bg) * a) / div);
+					b = bb + Vector256.ConvertToInt32(Vector256.ConvertToSingle((b - bb) * a) / div);
+					result = r | (g << 8) | (b << 16) | (ra << 24);
+				}
+
+				// nothing below takes the source color as-is, and a transparent source leaves the backdrop as-is
+				var empty = Vector256.Equals(ba, Vector256<int>.Zero);
+				result = Select(empty, (s & Vector256.Create(0x00FFFFFF)) | (a << 24), result);
+				result = Select(Vector256.Equals(sa, Vector256<int>.Zero), d, result);
+
+				result.StoreUnsafe(ref MemoryMarshal.GetReference(dst), (nuint)i);
+			}
+		}
+
+		for (; i < src.Length; i++)
+			backdrop[i] = Blend(source[i], backdrop[i], mode, opacity);
+	}
+
+	/// <summary>
+	/// Blends a single source pixel onto a backdrop pixel. Matches the results of the vectorized path.
+	/// </summary>
+	[MethodImpl(MethodImplOptions.AggressiveOptimization)]
+	public static Color Blend(Color s, Color d, Aseprite.BlendMode mode, int opacity)
+	{
+		if (s.A == 0)
+			return d;
+
+		var a = Mul(s.A, opacity);
+		if (d.A == 0)
+			return new Color(s.R, s.G, s.B, (byte)a);
+
+		int r, g, b;
+		switch (mode)
+		{
+			case Aseprite.BlendMode.Hue:
+			case Aseprite.BlendMode.Saturation:
+			case Aseprite.BlendMode.Color:
+			case Aseprite.BlendMode.Luminosity:
+				BlendHsl(mode, d.R, d.G, d.B, s.R, s.G, s.B, out r, out g, out b);
+				break;
+			default:
+				r = BlendChannel(mode, d.R, s.R);
+				g = BlendChannel(mode, d.G, s.G);
+				b = BlendChannel(mode, d.B, s.B);
+				break;
+		}
+
+		var ra = a + d.A - Mul(d.A, a);
+		return new Color(
+			(byte)(d.R + (r - d.R) * a / ra),
+			(byte)(d.G + (g - d.G) * a / ra),
+			(byte)(d.B + (b - d.B) * a / ra),
+			(byte)ra);
+	}
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<int> BlendChannel(Aseprite.BlendMode mode, Vector256<int> b, Vector256<int> s)
+	{
+		switch (mode)
+		{
+			case Aseprite.BlendMode.Multiply:
+				return Mul(b, s);
+			case Aseprite.BlendMode.Screen:
+				return b + s - Mul(b, s);
+			case Aseprite.BlendMode.Overlay:
+				return HardLight(s, b);
+			case Aseprite.BlendMode.Darken:
+				return Vector256.Min(b, s);
+			case Aseprite.BlendMode.Lighten:
+				return Vector256.Max(b, s);
+			case Aseprite.BlendMode.ColorDodge:
+			{
+				var inv = Max - s;
+				var result = Select(Vector256.GreaterThanOrEqual(b, inv), Max, Div(b, Vector256.Max(inv, Vector256<int>.One)));
+				return Select(Vector256.Equals(b, Vector256<int>.Zero), Vector256<int>.Zero, result);
+			}
+			case Aseprite.BlendMode.ColorBurn:
+			{
+				var inv = Max - b;
+				var result = Select(Vector256.GreaterThanOrEqual(inv, s), Vector256<int>.Zero, Max - Div(inv, Vector256.Max(s, Vector256<int>.One)));
+				return Select(Vector256.Equals(b, Max), Max, result);
+			}
+			case Aseprite.BlendMode.HardLight:
+				return HardLight(b, s);
+			case Aseprite.BlendMode.SoftLight:
+			{
+				var bf = Vector256.ConvertToSingle(b) / 255f;
+				var sf = Vector256.ConvertToSingle(s) / 255f;
+				var one = Vector256<float>.One;
+				var d = Vector256.ConditionalSelect(
+					Vector256.LessThanOrEqual(bf, Vector256.Create(0.25f)),
+					((Vector256.Create(16f) * bf - Vector256.Create(12f)) * bf + Vector256.Create(4f)) * bf,
+					Vector256.Sqrt(bf));
+				var two = Vector256.Create(2f);
+				var r = Vector256.ConditionalSelect(
+					Vector256.LessThanOrEqual(sf, Vector256.Create(0.5f)),
+					bf - (one - two * sf) * bf * (one - bf),
+					bf + (two * sf - one) * (d - bf));
+				return Vector256.ConvertToInt32(r * 255f + Vector256.Create(0.5f));
+			}
+			case Aseprite.BlendMode.Difference:
+				return Vector256.Abs(b - s);
+			case Aseprite.BlendMode.Exclusion:
+				return b + s - (Mul(b, s) << 1);
+			case Aseprite.BlendMode.Addition:
+				return Vector256.Min(b + s, Max);
+			case Aseprite.BlendMode.Subtract:
+				return Vector256.Max(b - s, Vector256<int>.Zero);
+			case Aseprite.BlendMode.Divide:
+			{
+				var result = Select(Vector256.GreaterThanOrEqual(b, s), Max, Div(b, Vector256.Max(s, Vector256<int>.One)));
+				return Select(Vector256.Equals(b, Vector256<int>.Zero), Vector256<int>.Zero, result);
+			}
+			default:
+				return s;
+		}
+
+		static Vector256<int> HardLight(Vector256<int> b, Vector256<int> s)
+		{
+			var s2 = s << 1;
+			return Select(Vector256.LessThan(s, Vector256.Create(128)), Mul(b, s2), b + (s2 - Max) - Mul(b, s2 - Max));
+		}
+	}
+
+	private static int BlendChannel(Aseprite.BlendMode mode, int b, int s)
+	{
+		switch (mode)
+		{
+			case Aseprite.BlendMode.Multiply:
+				return Mul(b, s);
+			case Aseprite.BlendMode.Screen:
+				return b + s - Mul(b, s);
+			case Aseprite.BlendMode.Overlay:
+				return HardLight(s, b);
+			case Aseprite.BlendMode.Darken:
+				return Math.Min(b, s);
+			case Aseprite.BlendMode.Lighten:
+				return Math.Max(b, s);
+			case Aseprite.BlendMode.ColorDodge:
+				if (b == 0)
+					return 0;
+				return b >= 255 - s ? 255 : Div(b, 255 - s);
+			case Aseprite.BlendMode.ColorBurn:
+				if (b == 255)
+					return 255;
+				return 255 - b >= s ? 0 : 255 - Div(255 - b, s);
+			case Aseprite.BlendMode.HardLight:
+				return HardLight(b, s);
+			case Aseprite.BlendMode.SoftLight:
+			{
+				var bf = b / 255f;
+				var sf = s / 255f;
+				var d = bf <= 0.25f ? ((16f * bf - 12f) * bf + 4f) * bf : MathF.Sqrt(bf);
+				var r = sf <= 0.5f ? bf - (1f - 2f * sf) * bf * (1f - bf) : bf + (2f * sf - 1f) * (d - bf);
+				return (int)(r * 255f + 0.5f);
+			}
+			case Aseprite.BlendMode.Difference:
+				return Math.Abs(b - s);
+			case Aseprite.BlendMode.Exclusion:
+				return b + s - (Mul(b, s) << 1);
+			case Aseprite.BlendMode.Addition:
+				return Math.Min(b + s, 255);
+			case Aseprite.BlendMode.Subtract:
+				return Math.Max(b - s, 0);
+			case Aseprite.BlendMode.Divide:
+				if (b == 0)
+					return 0;
+				return b >= s ? 255 : Div(b, s);
+			default:
+				return s;
+		}
+
+		static int HardLight(int b, int s)
+		{
+			var s2 = s << 1;
+			return s < 128 ? Mul(b, s2) : b + (s2 - 255) - Mul(b, s2 - 255);
+		}
+	}
+
+	/// <summary>
+	/// The non-separable modes, which mix hue, saturation and luminosity rather than each channel
+	/// </summary>
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static void BlendHsl(Aseprite.BlendMode mode,
+		Vector256<int> br, Vector256<int> bg, Vector256<int> bb,
+		Vector256<int> sr, Vector256<int> sg, Vector256<int> sb,
+		out Vector256<int> r, out Vector256<int> g, out Vector256<int> b)
+	{
+		var scale = Vector256.Create(1f / 255f);
+		var (fbr, fbg, fbb) = (Vector256.ConvertToSingle(br) * scale, Vector256.ConvertToSingle(bg) * scale, Vector256.ConvertToSingle(bb) * scale);
+		var (fsr, fsg, fsb) = (Vector256.ConvertToSingle(sr) * scale, Vector256.ConvertToSingle(sg) * scale, Vector256.ConvertToSingle(sb) * scale);
+		Vector256<float> fr, fg, fb;
+
+		switch (mode)
+		{
+			case Aseprite.BlendMode.Hue:
+				(fr, fg, fb) = SetSat(fsr, fsg, fsb, Sat(fbr, fbg, fbb));
+				(fr, fg, fb) = SetLum(fr, fg, fb, Lum(fbr, fbg, fbb));
+				break;
+			case Aseprite.BlendMode.Saturation:
+				(fr, fg, fb) = SetSat(fbr, fbg, fbb, Sat(fsr, fsg, fsb));
+				(fr, fg, fb) = SetLum(fr, fg, fb, Lum(fbr, fbg, fbb));
+				break;
+			case Aseprite.BlendMode.Color:
+				(fr, fg, fb) = SetLum(fsr, fsg, fsb, Lum(fbr, fbg, fbb));
+				break;
+			default:
+				(fr, fg, fb) = SetLum(fbr, fbg, fbb, Lum(fsr, fsg, fsb));
+				break;
+		}
+
+		var max = Vector256.Create(255f);
+		r = Vector256.ConvertToInt32(fr * max);
+		g = Vector256.ConvertToInt32(fg * max);
+		b = Vector256.ConvertToInt32(fb * max);
+
+		static Vector256<float> Lum(Vector256<float> r, Vector256<float> g, Vector256<float> b)
+			=> Vector256.Create(0.3f) * r + Vector256.Create(0.59f) * g + Vector256.Create(0.11f) * b;
+
+		static Vector256<float> Sat(Vector256<float> r, Vector256<float> g, Vector256<float> b)
+			=> Vector256.Max(r, Vector256.Max(g, b)) - Vector256.Min(r, Vector256.Min(g, b));
+
+		static (Vector256<float>, Vector256<float>, Vector256<float>) SetLum(Vector256<float> r, Vector256<float> g, Vector256<float> b, Vector256<float> l)
+		{
+			var d = l - Lum(r, g, b);
+			r += d;
+			g += d;
+			b += d;
+
+			// clip back into range, keeping the luminosity
+			l = Lum(r, g, b);
+			var n = Vector256.Min(r, Vector256.Min(g, b));
+			var x = Vector256.Max(r, Vector256.Max(g, b));
+
+			var under = Vector256.LessThan(n, Vector256<float>.Zero);
+			var lowScale = l / (l - n);
+			r = Vector256.ConditionalSelect(under, l + (r - l) * lowScale, r);
+			g = Vector256.ConditionalSelect(under, l + (g - l) * lowScale, g);
+			b = Vector256.ConditionalSelect(under, l + (b - l) * lowScale, b);
+
+			var over = Vector256.GreaterThan(x, Vector256<float>.One);
+			var highScale = (Vector256<float>.One - l) / (x - l);
+			r = Vector256.ConditionalSelect(over, l + (r - l) * highScale, r);
+			g = Vector256.ConditionalSelect(over, l + (g - l) * highScale, g);
+			b = Vector256.ConditionalSelect(over, l + (b - l) * highScale, b);
+
+			return (r, g, b);
+		}
+
+		static (Vector256<float>, Vector256<float>, Vector256<float>) SetSat(Vector256<float> r, Vector256<float> g, Vector256<float> b, Vector256<float> s)
+		{
+			// the smallest channel becomes 0, the largest becomes s, and the middle one keeps its relative place
+			var n = Vector256.Min(r, Vector256.Min(g, b));
+			var range = Vector256.Max(r, Vector256.Max(g, b)) - n;
+			var any = Vector256.GreaterThan(range, Vector256<float>.Zero);
+			var scale = s / range;
+			return (
+				Vector256.ConditionalSelect(any, (r - n) * scale, Vector256<float>.Zero),
+				Vector256.ConditionalSelect(any, (g - n) * scale, Vector256<float>.Zero),
+				Vector256.ConditionalSelect(any, (b - n) * scale, Vector256<float>.Zero));
+		}
+	}
+
+	private static void BlendHsl(Aseprite.BlendMode mode, int br, int bg, int bb, int sr, int sg, int sb, out int r, out int g, out int b)
+	{
+		const float scale = 1f / 255f;
+		float fbr = br * scale, fbg = bg * scale, fbb = bb * scale;
+		float fsr = sr * scale, fsg = sg * scale, fsb = sb * scale;
+		float fr, fg, fb;
+
+		switch (mode)
+		{
+			case Aseprite.BlendMode.Hue:
+				(fr, fg, fb) = SetSat(fsr, fsg, fsb, Sat(fbr, fbg, fbb));
+				(fr, fg, fb) = SetLum(fr, fg, fb, Lum(fbr, fbg, fbb));
+				break;
+			case Aseprite.BlendMode.Saturation:
+				(fr, fg, fb) = SetSat(fbr, fbg, fbb, Sat(fsr, fsg, fsb));
+				(fr, fg, fb) = SetLum(fr, fg, fb, Lum(fbr, fbg, fbb));
+				break;
+			case Aseprite.BlendMode.Color:
+				(fr, fg, fb) = SetLum(fsr, fsg, fsb, Lum(fbr, fbg, fbb));
+				break;
+			default:
+				(fr, fg, fb) = SetLum(fbr, fbg, fbb, Lum(fsr, fsg, fsb));
+				break;
+		}
+
+		r = (int)(fr * 255f);
+		g = (int)(fg * 255f);
+		b = (int)(fb * 255f);
+
+		static float Lum(float r, float g, float b)
+			=> 0.3f * r + 0.59f * g + 0.11f * b;
+
+		static float Sat(float r, float g, float b)
+			=> Math.Max(r, Math.Max(g, b)) - Math.Min(r, Math.Min(g, b));
+
+		static (float, float, float) SetLum(float r, float g, float b, float l)
+		{
+			var d = l - Lum(r, g, b);
+			r += d;
+			g += d;
+			b += d;
+
+			// clip back into range, keeping the luminosity
+			l = Lum(r, g, b);
+			var n = Math.Min(r, Math.Min(g, b));
+			var x = Math.Max(r, Math.Max(g, b));
+
+			if (n < 0)
+			{
+				var lowScale = l / (l - n);
+				r = l + (r - l) * lowScale;
+				g = l + (g - l) * lowScale;
+				b = l + (b - l) * lowScale;
+			}
+
+			if (x > 1)
+			{
+				var highScale = (1 - l) / (x - l);
+				r = l + (r - l) * highScale;
+				g = l + (g - l) * highScale;
+				b = l + (b - l) * highScale;
+			}
+
+			return (r, g, b);
+		}
+
+		static (float, float, float) SetSat(float r, float g, float b, float s)
+		{
+			// the smallest channel becomes 0, the largest becomes s, and the middle one keeps its relative place
+			var n = Math.Min(r, Math.Min(g, b));
+			var range = Math.Max(r, Math.Max(g, b)) - n;
+			if (range <= 0)
+				return (0, 0, 0);
+			var scale = s / range;
+			return ((r - n) * scale, (g - n) * scale, (b - n) * scale);
+		}
+	}
+}
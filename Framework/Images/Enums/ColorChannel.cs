@@ -0,0 +1,12 @@
+namespace Foster.Framework;
+
+/// <summary>
+/// A single channel of a Color
+/// </summary>
+public enum ColorChannel
+{
+	R,
+	G,
+	B,
+	A,
+}
@@ -0,0 +1,25 @@
+namespace Foster.Framework;
+
+/// <summary>
+/// The algorithm the <see cref="Packer"/> uses to place images on a page
+/// </summary>
+public enum PackerMode
+{
+	/// <summary>
+	/// A binary tree that grows right or down as images are added.
+	/// Fast, but wastes space when images have very different aspect ratios.
+	/// </summary>
+	Tree,
+
+	/// <summary>
+	/// Tracks every maximal free rectangle and places each image where it leaves the shortest leftover side.
+	/// Usually the densest, but the slowest for large numbers of images.
+	/// </summary>
+	MaxRects,
+
+	/// <summary>
+	/// Tracks the top edge of the placed images and places each image as low as possible.
+	/// Nearly as dense as MaxRects, and much faster for large numbers of images.
+	/// </summary>
+	Skyline,
+}
@@ -0,0 +1,28 @@
+namespace Foster.Framework;
+
+/// <summary>
+/// How pixels are blended onto an Image.
+/// All blend modes expect premultiplied-alpha pixels.
+/// </summary>
+public enum PixelBlend
+{
+	/// <summary>
+	/// Replaces the destination pixels
+	/// </summary>
+	Copy,
+
+	/// <summary>
+	/// Source-over blending
+	/// </summary>
+	Normal,
+
+	/// <summary>
+	/// Adds the source to the destination
+	/// </summary>
+	Additive,
+
+	/// <summary>
+	/// Multiplies the source and destination, where they overlap
+	/// </summary>
+	Multiply,
+}
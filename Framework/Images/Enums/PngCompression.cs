@@ -0,0 +1,23 @@
+namespace Foster.Framework;
+
+/// <summary>
+/// How much effort is spent compressing a PNG
+/// </summary>
+public enum PngCompression
+{
+	/// <summary>
+	/// Uses the "Up" filter for every row and the fastest deflate level.
+	/// Suited to screenshots and captures where writing must not hitch a frame.
+	/// </summary>
+	Fast,
+
+	/// <summary>
+	/// Picks the best filter for each row and uses the default deflate level
+	/// </summary>
+	Balanced,
+
+	/// <summary>
+	/// Picks the best filter for each row and uses the strongest deflate level
+	/// </summary>
+	Smallest,
+}
@@ -0,0 +1,23 @@
+namespace Foster.Framework;
+
+/// <summary>
+/// The filter used when resampling an Image to a different size
+/// </summary>
+public enum ResampleFilter
+{
+	/// <summary>
+	/// Averages every source pixel covered by each destination pixel.
+	/// Fastest, and exact for halving sizes (ex. mip chains).
+	/// </summary>
+	Box,
+
+	/// <summary>
+	/// Linear interpolation, widened when downscaling so every source pixel contributes
+	/// </summary>
+	Bilinear,
+
+	/// <summary>
+	/// Mitchell-Netravali cubic filter. Sharper than Bilinear with very little ringing.
+	/// </summary>
+	Mitchell,
+}
@@ -21,6 +21,11 @@ public class Font : IDisposable
 		public bool Visible;
 	}
 
+	/// <summary>
+	/// A Kerning value between two glyphs, as indices into the glyph set it was requested with
+	/// </summary>
+	public readonly record struct KerningPair(int First, int Second, float Advance);
+
 	private IntPtr fontPtr;
 	private IntPtr dataPtr;
 	private GCHandle dataHandle;
@@ -128,6 +133,30 @@ public class Font : IDisposable
 		return Platform.FosterFontGetKerning(fontPtr, glyph1, glyph2, scale);
 	}
 
+	/// <summary>
+	/// Gets every non-zero Kerning value between all the glyphs in the given set, at a given scale.
+	/// This reads the kerning tables directly and only visits pairs the font kerns, which is much faster than querying each pair.
+	/// </summary>
+	public unsafe List<KerningPair> GetKerningPairs(ReadOnlySpan<int> glyphs, float scale)
+	{
+		if (fontPtr == IntPtr.Zero)
+			throw new Exception("Trying to use an invalid Font");
+
+		Platform.FosterKerningPair* pairs;
+		int count;
+
+		// the native side collects the pairs in a single pass, into a buffer it owns
+		fixed (int* glyphsPtr = glyphs)
+			pairs = Platform.FosterFontGetKerningPairs(fontPtr, glyphsPtr, glyphs.Length, scale, out count);
+
+		var result = new List<KerningPair>(count);
+		for (int i = 0; i < count; i++)
+			result.Add(new(pairs[i].First, pairs[i].Second, pairs[i].Advance));
+
+		Platform.FosterFontFreeKerningPairs(pairs);
+		return result;
+	}
+
 	/// <summary>
 	/// Gets Character Metrics of a given char at a given scale
 	/// </summary>
@@ -215,6 +244,95 @@ public class Font : IDisposable
 		return true;
 	}
 
+	/// <summary>
+	/// Renders many characters in a single call, one after another into the given Color buffer.
+	/// Each character takes up (Width * Height) pixels, and invisible characters take up no space.
+	/// If padding is larger than 0, the characters are rendered as Signed Distance Fields, and should be the
+	/// metrics returned by <see cref="GetDistanceFieldCharacter"/>.
+	/// This is safe to call from multiple threads at once.
+	/// </summary>
+	public unsafe bool GetPixels(ReadOnlySpan<Character> characters, Span<Color> destination, int padding = 0)
+	{
+		if (fontPtr == IntPtr.Zero)
+			throw new Exception("Trying to use an invalid Font");
+
+		if (characters.Length <= 0)
+			return true;
+
+		var glyphs = new int[characters.Length * 3];
+		var count = 0;
+		var length = 0;
+		var scale = characters[0].Scale;
+
+		foreach (var it in characters)
+		{
+			if (!it.Visible)
+				continue;
+
+			if (it.Scale != scale)
+				throw new ArgumentException("All Characters must be the same Scale");
+
+			glyphs[count] = it.GlyphIndex;
+			glyphs[characters.Length + count] = it.Width;
+			glyphs[characters.Length * 2 + count] = it.Height;
+			length += it.Width * it.Height;
+			count++;
+		}
+
+		if (destination.Length < length)
+			return false;
+
+		fixed (int* ptr = glyphs)
+		fixed (Color* dest = destination)
+		{
+			Platform.FosterFontGetPixelsBatch(fontPtr, new(dest), ptr, ptr + characters.Length, ptr + characters.Length * 2, count, scale, padding);
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Gets the Character Metrics of a Signed Distance Field of the given character.
+	/// The field is larger than the character by the padding on every side.
+	/// </summary>
+	public Character GetDistanceFieldCharacter(in Character character, int padding)
+	{
+		if (!character.Visible)
+			return character;
+
+		return character with
+		{
+			Width = character.Width + padding * 2,
+			Height = character.Height + padding * 2,
+			Offset = character.Offset - new Vector2(padding, padding),
+		};
+	}
+
+	/// <summary>
+	/// Renders a Signed Distance Field of a character to the given Color buffer.
+	/// The character should be the metrics returned by <see cref="GetDistanceFieldCharacter"/>.
+	/// Every channel holds the distance, where 128 is the glyph edge and it falls off to 0 and 255 across the padding.
+	/// </summary>
+	public bool GetDistanceFieldPixels(in Character character, int padding, Span<Color> destination)
+	{
+		if (fontPtr == IntPtr.Zero)
+			throw new Exception("Trying to use an invalid Font");
+
+		if (!character.Visible)
+			return false;
+
+		if (destination.Length < character.Width * character.Height)
+			return false;
+
+		unsafe
+		{
+			fixed (Color* ptr = destination)
+				Platform.FosterFontGetSDF(fontPtr, new(ptr), character.GlyphIndex, character.Width, character.Height, character.Scale, padding);
+		}
+
+		return true;
+	}
+
 	public void Dispose()
 	{
 		if (dataPtr != IntPtr.Zero)
@@ -1,3 +1,4 @@
+using System.Buffers;
 using System.Diagnostics;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
@@ -55,6 +56,8 @@ public class Image : IDisposable
 	private IntPtr ptr;
 	private GCHandle handle;
 	private bool unmanaged = false;
+	private Color[]? pooled;
+	private Color[]? arena;
 
 	public Image()
 	{
@@ -87,10 +90,24 @@ public class Image : IDisposable
 		unmanaged = false;
 	}
 
+	/// <summary>
+	/// Creates an Image over part of a larger array, which must have been allocated on the pinned object heap.
+	/// The Image keeps the array alive, so many Images can share one allocation.
+	/// </summary>
+	internal unsafe Image(int width, int height, Color[] pinnedArena, int offset)
+	{
+		Width = width;
+		Height = height;
+		arena = pinnedArena;
+		ptr = (IntPtr)Unsafe.AsPointer(ref Unsafe.Add(ref MemoryMarshal.GetArrayDataReference(pinnedArena), offset));
+		unmanaged = false;
+	}
+
 	public Image(string file)
 	{
-		using var stream = File.OpenRead(file);
-		Load(stream);
+		// map the file instead of reading it, so its contents never touch the managed heap
+		using var mapped = new MappedFile(file);
+		Load(mapped.Data);
 	}
 
 	public Image(Stream stream)
@@ -98,17 +115,45 @@ public class Image : IDisposable
 		Load(stream);
 	}
 
+	/// <summary>
+	/// Decodes an Image from encoded file data (ex. a PNG or QOI file in memory, or part of a pack file)
+	/// </summary>
+	public Image(ReadOnlySpan<byte> data)
+	{
+		Load(data);
+	}
+
 	~Image()
 	{
 		Dispose();
 	}
 
-	private unsafe void Load(Stream stream)
+	private void Load(Stream stream)
 	{
-		// get all the bytes
-		var data = new byte[stream.Length - stream.Position];
-		stream.Read(data);
+		// use the stream's own buffer if it's already in memory
+		if (stream is MemoryStream memory && memory.TryGetBuffer(out var buffer))
+		{
+			Load(buffer.AsSpan((int)memory.Position));
+			memory.Position = memory.Length;
+			return;
+		}
+
+		// otherwise read the bytes into a pooled buffer
+		var length = (int)(stream.Length - stream.Position);
+		var data = ArrayPool<byte>.Shared.Rent(length);
+		try
+		{
+			stream.ReadExactly(data, 0, length);
+			Load(data.AsSpan(0, length));
+		}
+		finally
+		{
+			ArrayPool<byte>.Shared.Return(data);
+		}
+	}
 
+	private unsafe void Load(ReadOnlySpan<byte> data)
+	{
 		// load image from byte data
 		nint mem;
 		int w, h;
@@ -129,6 +174,165 @@ public class Image : IDisposable
 		unmanaged = true;
 	}
 
+	/// <summary>
+	/// Loads many Image files at once, decoding them in parallel across worker threads.
+	/// The Images are returned in the same order as the paths.
+	/// Creating Textures from them must still happen on the main thread.
+	/// </summary>
+	/// <param name="maxDegreeOfParallelism">Maximum number of worker threads, or -1 to use every core</param>
+	public static Image[] LoadMany(IEnumerable<string> paths, int maxDegreeOfParallelism = -1)
+	{
+		var files = paths as IReadOnlyList<string> ?? paths.ToArray();
+		return LoadMany(files.Count, maxDegreeOfParallelism, i => new Image(files[i]));
+	}
+
+	/// <summary>
+	/// Decodes many Images from encoded file data at once, in parallel across worker threads.
+	/// The Images are returned in the same order as the data.
+	/// Creating Textures from them must still happen on the main thread.
+	/// </summary>
+	/// <param name="maxDegreeOfParallelism">Maximum number of worker threads, or -1 to use every core</param>
+	public static Image[] LoadMany(IReadOnlyList<ReadOnlyMemory<byte>> data, int maxDegreeOfParallelism = -1)
+	{
+		return LoadMany(data.Count, maxDegreeOfParallelism, i => new Image(data[i].Span));
+	}
+
+	private static Image[] LoadMany(int count, int maxDegreeOfParallelism, Func<int, Image> load)
+	{
+		var results = new Image[count];
+		var options = new ParallelOptions { MaxDegreeOfParallelism = maxDegreeOfParallelism };
+
+		try
+		{
+			// stb_image and qoi keep no global state, so each decode is independent
+			Parallel.For(0, count, options, i => results[i] = load(i));
+		}
+		catch
+		{
+			// don't leak the native memory of any Images that did load
+			foreach (var it in results)
+				it?.Dispose();
+			throw;
+		}
+
+		return results;
+	}
+
+	/// <summary>
+	/// Gets the size of an Image from encoded file data, without decoding it
+	/// </summary>
+	public static unsafe bool TryGetInfo(ReadOnlySpan<byte> data, out int width, out int height)
+	{
+		fixed (byte* it = data)
+		{
+			if (Platform.FosterImageGetInfo(it, data.Length, out width, out height) != 0)
+				return true;
+		}
+
+		width = height = 0;
+		return false;
+	}
+
+	/// <summary>
+	/// Decodes encoded file data directly into the given destination, which must hold at least (width * height) pixels.
+	/// Use <see cref="TryGetInfo"/> to find the required size.
+	/// </summary>
+	public static unsafe bool TryLoadInto(ReadOnlySpan<byte> data, Span<Color> destination, out int width, out int height)
+	{
+		fixed (byte* it = data)
+		fixed (Color* dest = destination)
+		{
+			if (Platform.FosterImageLoadInto(it, data.Length, dest, destination.Length * 4, out width, out height) != 0)
+				return true;
+		}
+
+		width = height = 0;
+		return false;
+	}
+
+	/// <summary>
+	/// Decodes encoded file data into pixels rented from <see cref="ArrayPool{T}.Shared"/>,
+	/// which are returned to the pool when the Image is disposed.
+	/// This is useful for short-lived Images, such as ones that are only loaded to create a Texture.
+	/// </summary>
+	public static Image LoadPooled(ReadOnlySpan<byte> data)
+	{
+		if (!TryGetInfo(data, out var width, out var height))
+			throw new Exception("Failed to load Image");
+
+		var pixels = ArrayPool<Color>.Shared.Rent(width * height);
+		if (!TryLoadInto(data, pixels, out width, out height))
+		{
+			ArrayPool<Color>.Shared.Return(pixels);
+			throw new Exception("Failed to load Image");
+		}
+
+		return new Image(width, height, pixels) { pooled = pixels };
+	}
+
+	/// <summary>
+	/// Memory-maps a file and decodes it into pixels rented from <see cref="ArrayPool{T}.Shared"/>,
+	/// which are returned to the pool when the Image is disposed.
+	/// </summary>
+	public static Image LoadPooled(string file)
+	{
+		using var mapped = new MappedFile(file);
+		return LoadPooled(mapped.Data);
+	}
+
+	/// <summary>
+	/// Decodes a QOI image while reading it from the stream in small chunks, so the
+	/// encoded file is never held in memory as a whole.
+	/// The decoder may read a little past the end of the image.
+	/// </summary>
+	public static unsafe Image ReadQoi(Stream stream)
+	{
+		[UnmanagedCallersOnly]
+		static unsafe int Read(IntPtr context, IntPtr data, int size)
+		{
+			// exceptions can't cross back into native code, so failed reads end the data instead
+			try
+			{
+				var stream = GCHandle.FromIntPtr(context).Target as Stream;
+				return stream?.Read(new Span<byte>(data.ToPointer(), size)) ?? 0;
+			}
+			catch
+			{
+				return 0;
+			}
+		}
+
+		var handle = GCHandle.Alloc(stream);
+		try
+		{
+			var context = GCHandle.ToIntPtr(handle);
+			if (Platform.FosterImageReadQOIHeader(&Read, context, out var width, out var height) == 0)
+				throw new Exception("Failed to load QOI Image header");
+
+			var image = new Image(width, height);
+			if (Platform.FosterImageReadQOIPixels(&Read, context, image.ptr.ToPointer(), width, height) == 0)
+			{
+				image.Dispose();
+				throw new Exception("Failed to load QOI Image");
+			}
+
+			return image;
+		}
+		finally
+		{
+			handle.Free();
+		}
+	}
+
+	/// <summary>
+	/// Decodes a QOI image file while reading it in small chunks
+	/// </summary>
+	public static Image ReadQoi(string path)
+	{
+		using var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 0);
+		return ReadQoi(stream);
+	}
+
 	/// <summary>
 	/// Completely dispose of the image.
 	/// </summary>
@@ -143,6 +347,14 @@ public class Image : IDisposable
 			handle.Free();
 		}
 
+		if (pooled != null)
+		{
+			ArrayPool<Color>.Shared.Return(pooled);
+			pooled = null;
+		}
+
+		arena = null;
+
 		handle = new();
 		ptr = new();
 		unmanaged = false;
@@ -151,20 +363,22 @@ public class Image : IDisposable
 	}
 
 	/// <summary>
-	/// Writes the image to a PNG file
+	/// Writes the image to a PNG file.
+	/// This is safe to call from any thread, as long as the Image isn't modified while writing.
 	/// </summary>
-	public void WritePng(string path)
+	public void WritePng(string path, PngCompression compression = PngCompression.Balanced)
 	{
 		using var stream = File.Create(path);
-		WritePng(stream);
+		WritePng(stream, compression);
 	}
 
 	/// <summary>
-	/// Write the image to PNG
+	/// Write the image to PNG.
+	/// This is safe to call from any thread, as long as the Image isn't modified while writing.
 	/// </summary>
-	public void WritePng(Stream stream)
+	public void WritePng(Stream stream, PngCompression compression = PngCompression.Balanced)
 	{
-		Write(stream, ImageWriteFormat.Png);
+		PngWriter.Write(stream, Data, Width, Height, compression);
 	}
 
 	/// <summary>
@@ -177,7 +391,8 @@ public class Image : IDisposable
 	}
 
 	/// <summary>
-	/// Write the image to QOI
+	/// Write the image to QOI.
+	/// The encoded data is written to the stream in small chunks as it's produced.
 	/// </summary>
 	public void WriteQoi(Stream stream)
 	{
@@ -348,13 +563,135 @@ public class Image : IDisposable
 		CopyPixels(source.Data, source.Width, source.Height, new RectInt(0, 0, source.Width, source.Height), destination ?? Point2.Zero, blend);
 	}
 
+	/// <summary>
+	/// Copies pixels onto this Image using a vectorized blend, which is much faster than blending with a delegate.
+	/// The source and destination pixels should be premultiplied.
+	/// </summary>
+	public unsafe void CopyPixels(ReadOnlySpan<Color> sourcePixels, int sourceWidth, int sourceHeight, in RectInt sourceRect, in Point2 destination, PixelBlend blend, byte opacity = 255)
+	{
+		Debug.Assert(sourcePixels.Length >= sourceWidth * sourceHeight);
+
+		var target = new RectInt(destination.X, destination.Y, sourceRect.Width, sourceRect.Height);
+
+		var dst = Bounds.OverlapRect(in target);
+		if (dst.Width <= 0 || dst.Height <= 0)
+			return;
+
+		var p = sourceRect.TopLeft + (dst.TopLeft - target.TopLeft);
+		var data = Data;
+
+		for (int y = 0; y < dst.Height; y++)
+		{
+			var src = sourcePixels.Slice((p.Y + y) * sourceWidth + p.X, dst.Width);
+			var row = data.Slice((dst.Y + y) * Width + dst.X, dst.Width);
+			PixelKernels.Blend(src, row, blend, opacity);
+		}
+	}
+
+	public void CopyPixels(ReadOnlySpan<Color> sourcePixels, int sourceWidth, int sourceHeight, in Point2? destination, PixelBlend blend, byte opacity = 255)
+	{
+		CopyPixels(sourcePixels, sourceWidth, sourceHeight, new RectInt(0, 0, sourceWidth, sourceHeight), destination ?? Point2.Zero, blend, opacity);
+	}
+
+	public void CopyPixels(Image source, in RectInt sourceRect, Point2? destination, PixelBlend blend, byte opacity = 255)
+	{
+		CopyPixels(source.Data, source.Width, source.Height, sourceRect, destination ?? Point2.Zero, blend, opacity);
+	}
+
+	public void CopyPixels(Image source, Point2? destination, PixelBlend blend, byte opacity = 255)
+	{
+		CopyPixels(source.Data, source.Width, source.Height, new RectInt(0, 0, source.Width, source.Height), destination ?? Point2.Zero, blend, opacity);
+	}
+
+	/// <summary>
+	/// Premultiplies every pixel by its alpha
+	/// </summary>
 	public void Premultiply()
 	{
-		unsafe
+		PixelKernels.Premultiply(Data);
+	}
+
+	/// <summary>
+	/// Rearranges the channels of every pixel, where each output channel is read from the given input channel.
+	/// For example, Swizzle(B, G, R, A) converts between RGBA and BGRA.
+	/// </summary>
+	public void Swizzle(ColorChannel r, ColorChannel g, ColorChannel b, ColorChannel a)
+	{
+		PixelKernels.Swizzle(Data, r, g, b, a);
+	}
+
+	/// <summary>
+	/// Converts every pixel to grayscale by its luminance, keeping alpha
+	/// </summary>
+	public void Grayscale()
+	{
+		PixelKernels.Grayscale(Data);
+	}
+
+	/// <summary>
+	/// Writes a single channel of every pixel to the destination, which must hold at least <see cref="PixelCount"/> values.
+	/// This is the data of an R8 Texture.
+	/// </summary>
+	public void GetChannel(ColorChannel channel, Span<byte> destination)
+	{
+		if (destination.Length < PixelCount)
+			throw new ArgumentException("Destination is smaller than the Image", nameof(destination));
+		PixelKernels.ToR8(Data, destination, channel);
+	}
+
+	/// <summary>
+	/// Writes the luminance of every pixel to the destination, which must hold at least <see cref="PixelCount"/> values.
+	/// </summary>
+	public void GetLuminance(Span<byte> destination)
+	{
+		if (destination.Length < PixelCount)
+			throw new ArgumentException("Destination is smaller than the Image", nameof(destination));
+		PixelKernels.ToR8(Data, destination, null);
+	}
+
+	/// <summary>
+	/// Creates an Image from single channel (R8) values.
+	/// If valueIsAlpha is true each pixel is (v, v, v, v), which is premultiplied white coverage,
+	/// otherwise each pixel is opaque gray (v, v, v, 255).
+	/// </summary>
+	public static Image FromR8(int width, int height, ReadOnlySpan<byte> values, bool valueIsAlpha = false)
+	{
+		if (values.Length < width * height)
+			throw new ArgumentException("Values are smaller than the Image", nameof(values));
+
+		var image = new Image(width, height);
+		PixelKernels.FromR8(values[..(width * height)], image.Data, valueIsAlpha);
+		return image;
+	}
+
+	/// <summary>
+	/// Creates a new Image resized to the given size with the given filter.
+	/// Set premultiplied if the pixels are already premultiplied by their alpha, otherwise
+	/// color is weighted by alpha while filtering so transparent pixels don't bleed into their neighbours.
+	/// </summary>
+	public Image Resize(int width, int height, ResampleFilter filter = ResampleFilter.Bilinear, bool premultiplied = false)
+	{
+		if (width <= 0 || height <= 0)
+			throw new Exception("Image must have a size larger than 0");
+
+		var result = new Image(width, height);
+		ImageResampler.Resample(Data, Width, Height, result.Data, width, height, filter, premultiplied);
+		return result;
+	}
+
+	/// <summary>
+	/// Creates the mip chain of this Image, not including the Image itself.
+	/// Each level is half the size of the previous, down to 1x1, and is filtered from the level above it.
+	/// </summary>
+	public Image[] GenerateMips(ResampleFilter filter = ResampleFilter.Box, bool premultiplied = false)
+	{
+		var mips = new List<Image>();
+		var source = this;
+		while (source.Width > 1 || source.Height > 1)
 		{
-			Color* pixels = (Color*)ptr.ToPointer();
-			for (int i = 0, n = PixelCount; i < n; ++i)
-				pixels[i] = pixels[i].Premultiply();
+			source = source.Resize(Math.Max(1, source.Width / 2), Math.Max(1, source.Height / 2), filter, premultiplied);
+			mips.Add(source);
 		}
+		return [.. mips];
 	}
 }
@@ -0,0 +1,189 @@
+using System.Numerics;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// Resamples pixels with a separable filter: each row is filtered horizontally,
+/// then each column vertically. Pixels are processed as Vector4 so every channel is filtered at once.
+/// </summary>
+internal static class ImageResampler
+{
+	/// <summary>
+	/// Images with at least this many destination pixels are resampled across threads
+	/// </summary>
+	private const int ParallelThreshold = 256 * 256;
+
+	/// <summary>
+	/// The source pixels and weights that contribute to each destination pixel along one axis
+	/// </summary>
+	private readonly struct Contributions(int[] starts, int[] counts, float[] weights, int stride)
+	{
+		public readonly int[] Starts = starts;
+		public readonly int[] Counts = counts;
+		public readonly float[] Weights = weights;
+		public readonly int Stride = stride;
+	}
+
+	public static void Resample(ReadOnlySpan<Color> source, int sourceWidth, int sourceHeight, Span<Color> destination, int width, int height, ResampleFilter filter, bool premultiplied)
+	{
+		var horizontal = GetContributions(sourceWidth, width, filter);
+		var vertical = GetContributions(sourceHeight, height, filter);
+
+		// convert to floats, weighting color by alpha so transparent pixels don't bleed their color
+		var input = new Vector4[sourceWidth * sourceHeight];
+		for (int i = 0; i < input.Length; i++)
+		{
+			var c = source[i].ToVector4();
+			if (!premultiplied)
+				c = new Vector4(c.X * c.W, c.Y * c.W, c.Z * c.W, c.W);
+			input[i] = c;
+		}
+
+		// horizontal pass, from (sourceWidth x sourceHeight) to (width x sourceHeight)
+		var temp = new Vector4[width * sourceHeight];
+		void Horizontal(int y)
+		{
+			var src = input.AsSpan(y * sourceWidth, sourceWidth);
+			var dst = temp.AsSpan(y * width, width);
+			for (int x = 0; x < width; x++)
+			{
+				var start = horizontal.Starts[x];
+				var weights = horizontal.Weights.AsSpan(x * horizontal.Stride, horizontal.Counts[x]);
+				var sum = Vector4.Zero;
+				for (int k = 0; k < weights.Length; k++)
+					sum += src[start + k] * weights[k];
+				dst[x] = sum;
+			}
+		}
+
+		// vertical pass, from (width x sourceHeight) to (width x height), accumulating whole rows at a time
+		var output = new Vector4[width * height];
+		void Vertical(int y)
+		{
+			var dst = output.AsSpan(y * width, width);
+			var start = vertical.Starts[y];
+			var weights = vertical.Weights.AsSpan(y * vertical.Stride, vertical.Counts[y]);
+			for (int k = 0; k < weights.Length; k++)
+			{
+				var src = temp.AsSpan((start + k) * width, width);
+				var w = weights[k];
+				for (int x = 0; x < dst.Length; x++)
+					dst[x] += src[x] * w;
+			}
+		}
+
+		if (width * height >= ParallelThreshold)
+		{
+			Parallel.For(0, sourceHeight, Horizontal);
+			Parallel.For(0, height, Vertical);
+		}
+		else
+		{
+			for (int y = 0; y < sourceHeight; y++)
+				Horizontal(y);
+			for (int y = 0; y < height; y++)
+				Vertical(y);
+		}
+
+		// back to bytes
+		for (int i = 0; i < output.Length; i++)
+		{
+			var c = Vector4.Clamp(output[i], Vector4.Zero, Vector4.One);
+			if (!premultiplied)
+			{
+				if (c.W > 0)
+					c = new Vector4(Math.Min(1, c.X / c.W), Math.Min(1, c.Y / c.W), Math.Min(1, c.Z / c.W), c.W);
+				else
+					c = Vector4.Zero;
+			}
+			else
+			{
+				// premultiplied color can never be larger than its alpha
+				c = Vector4.Min(c, new Vector4(c.W));
+			}
+
+			c = c * 255 + new Vector4(0.5f);
+			destination[i] = new Color((byte)c.X, (byte)c.Y, (byte)c.Z, (byte)c.W);
+		}
+	}
+
+	private static float Radius(ResampleFilter filter) => filter switch
+	{
+		ResampleFilter.Box => 0.5f,
+		ResampleFilter.Bilinear => 1.0f,
+		_ => 2.0f,
+	};
+
+	private static float Kernel(ResampleFilter filter, float x)
+	{
+		x = MathF.Abs(x);
+		switch (filter)
+		{
+			case ResampleFilter.Box:
+				return x < 0.5f ? 1.0f : (x == 0.5f ? 0.5f : 0.0f);
+
+			case ResampleFilter.Bilinear:
+				return x < 1.0f ? 1.0f - x : 0.0f;
+
+			default:
+			{
+				// Mitchell-Netravali, with B = C = 1/3
+				const float B = 1.0f / 3.0f;
+				const float C = 1.0f / 3.0f;
+				if (x < 1.0f)
+					return ((12 - 9 * B - 6 * C) * x * x * x + (-18 + 12 * B + 6 * C) * x * x + (6 - 2 * B)) / 6;
+				if (x < 2.0f)
+					return ((-B - 6 * C) * x * x * x + (6 * B + 30 * C) * x * x + (-12 * B - 48 * C) * x + (8 * B + 24 * C)) / 6;
+				return 0.0f;
+			}
+		}
+	}
+
+	private static Contributions GetContributions(int sourceSize, int size, ResampleFilter filter)
+	{
+		// when downscaling, the filter is widened so it covers every source pixel
+		var scale = size / (float)sourceSize;
+		var filterScale = Math.Min(1.0f, scale);
+		var radius = Radius(filter) / filterScale;
+		var stride = (int)MathF.Ceiling(radius * 2) + 2;
+
+		var starts = new int[size];
+		var counts = new int[size];
+		var weights = new float[size * stride];
+
+		for (int i = 0; i < size; i++)
+		{
+			var center = (i + 0.5f) / scale;
+			var left = Math.Max(0, (int)MathF.Floor(center - radius));
+			var right = Math.Min(sourceSize - 1, (int)MathF.Ceiling(center + radius));
+			var count = Math.Min(stride, right - left + 1);
+			var row = weights.AsSpan(i * stride, count);
+
+			var total = 0.0f;
+			for (int k = 0; k < count; k++)
+			{
+				row[k] = Kernel(filter, (left + k + 0.5f - center) * filterScale);
+				total += row[k];
+			}
+
+			// normalize, which also handles the filter being cut off at the edges
+			if (total != 0)
+			{
+				for (int k = 0; k < count; k++)
+					row[k] /= total;
+			}
+			else
+			{
+				// the filter fell between pixels, so use the nearest one
+				left = Math.Clamp((int)center, 0, sourceSize - 1);
+				count = 1;
+				weights[i * stride] = 1;
+			}
+
+			starts[i] = left;
+			counts[i] = count;
+		}
+
+		return new(starts, counts, weights, stride);
+	}
+}
@@ -0,0 +1,165 @@
+namespace Foster.Framework;
+
+/// <summary>
+/// Free space of a rectangular bin, kept as the list of maximal free rectangles.
+/// Rectangles are placed where they leave the shortest leftover side (best short side fit).
+/// </summary>
+internal sealed class MaxRectsBin
+{
+	public int Width { get; private set; }
+	public int Height { get; private set; }
+
+	private readonly List<RectInt> free = [];
+
+	public MaxRectsBin(int width, int height)
+	{
+		Reset(width, height);
+	}
+
+	/// <summary>
+	/// Empties the bin and sets its size
+	/// </summary>
+	public void Reset(int width, int height)
+	{
+		Width = width;
+		Height = height;
+		free.Clear();
+		free.Add(new(0, 0, width, height));
+	}
+
+	/// <summary>
+	/// Finds a place for a rectangle of the given size and marks it as used.
+	/// If rotation is allowed the rectangle may be placed with its width and height swapped.
+	/// </summary>
+	public bool TryInsert(int width, int height, bool allowRotation, out RectInt rect, out bool rotated)
+	{
+		rect = default;
+		rotated = false;
+
+		var found = false;
+		int bestShort = int.MaxValue, bestLong = int.MaxValue;
+
+		foreach (var it in free)
+		{
+			for (int turn = 0; turn < (allowRotation ? 2 : 1); turn++)
+			{
+				var w = turn == 0 ? width : height;
+				var h = turn == 0 ? height : width;
+				if (w > it.Width || h > it.Height)
+					continue;
+
+				var leftoverX = it.Width - w;
+				var leftoverY = it.Height - h;
+				var shortSide = Math.Min(leftoverX, leftoverY);
+				var longSide = Math.Max(leftoverX, leftoverY);
+
+				if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong))
+				{
+					rect = new RectInt(it.X, it.Y, w, h);
+					bestShort = shortSide;
+					bestLong = longSide;
+					rotated = turn == 1;
+					found = true;
+				}
+			}
+		}
+
+		if (found)
+			Split(rect);
+
+		return found;
+	}
+
+	/// <summary>
+	/// Returns a used rectangle to the free space.
+	/// It's joined with free rectangles that share a whole edge with it, but free space
+	/// otherwise fragments over time, and is only fully recovered by emptying the bin.
+	/// </summary>
+	public void Free(RectInt rect)
+	{
+		for (int i = 0; i < free.Count; i++)
+		{
+			var it = free[i];
+			RectInt joined;
+
+			if (it.Y == rect.Y && it.Height == rect.Height && (it.Right == rect.X || rect.Right == it.X))
+				joined = new(Math.Min(it.X, rect.X), it.Y, it.Width + rect.Width, it.Height);
+			else if (it.X == rect.X && it.Width == rect.Width && (it.Bottom == rect.Y || rect.Bottom == it.Y))
+				joined = new(it.X, Math.Min(it.Y, rect.Y), it.Width, it.Height + rect.Height);
+			else
+				continue;
+
+			// the joined rectangle may join others, so start over with it
+			free.RemoveAt(i);
+			rect = joined;
+			i = -1;
+		}
+
+		for (int i = free.Count - 1; i >= 0; i--)
+			if (Inside(free[i], rect))
+				free.RemoveAt(i);
+
+		foreach (var it in free)
+			if (Inside(rect, it))
+				return;
+
+		free.Add(rect);
+	}
+
+	/// <summary>
+	/// Splits every free rectangle the used one overlaps into the (up to 4) maximal rectangles around it
+	/// </summary>
+	private void Split(in RectInt used)
+	{
+		var count = free.Count;
+		for (int i = count - 1; i >= 0; i--)
+		{
+			var rect = free[i];
+			if (!rect.Overlaps(used))
+				continue;
+
+			free[i] = free[count - 1];
+			free.RemoveAt(count - 1);
+			count--;
+
+			if (used.X > rect.X)
+				free.Add(new(rect.X, rect.Y, used.X - rect.X, rect.Height));
+			if (used.Right < rect.Right)
+				free.Add(new(used.Right, rect.Y, rect.Right - used.Right, rect.Height));
+			if (used.Y > rect.Y)
+				free.Add(new(rect.X, rect.Y, rect.Width, used.Y - rect.Y));
+			if (used.Bottom < rect.Bottom)
+				free.Add(new(rect.X, used.Bottom, rect.Width, rect.Bottom - used.Bottom));
+		}
+
+		// remove rectangles contained by others. the untouched ones were already
+		// maximal among themselves, so only pairs with a new rectangle need checking
+		for (int i = free.Count - 1; i >= count; i--)
+		{
+			for (int j = 0; j < free.Count; j++)
+			{
+				if (i != j && Inside(free[i], free[j]))
+				{
+					free.RemoveAt(i);
+					break;
+				}
+			}
+		}
+
+		for (int i = Math.Min(count, free.Count) - 1; i >= 0; i--)
+		{
+			for (int j = count; j < free.Count; j++)
+			{
+				if (Inside(free[i], free[j]))
+				{
+					free.RemoveAt(i);
+					count--;
+					break;
+				}
+			}
+		}
+	}
+
+	private static bool Inside(in RectInt a, in RectInt b)
+		=> a.X >= b.X && a.Y >= b.Y && a.Right <= b.Right && a.Bottom <= b.Bottom;
+}
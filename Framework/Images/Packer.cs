@@ -1,3 +1,6 @@
+using System.Diagnostics;
+using System.Security.Cryptography;
+using System.Text;
 
 namespace Foster.Framework;
 
@@ -35,7 +38,13 @@ public class Packer
 		/// <summary>
 		/// The Frame Rectangle. This is the size of the image before it was packed
 		/// </summary>
-		RectInt Frame
+		RectInt Frame,
+
+		/// <summary>
+		/// If the image was turned 90 degrees clockwise on its page.
+		/// The Source Rectangle is the turned area, so its width is the height of the image.
+		/// </summary>
+		bool Rotated = false
 	);
 
 	/// <summary>
@@ -45,6 +54,26 @@ public class Packer
 	{
 		public readonly List<Image> Pages = [];
 		public readonly List<Entry> Entries = [];
+
+		/// <summary>
+		/// Total area of the packed images, in pixels, not including duplicates or padding
+		/// </summary>
+		public long UsedArea { get; init; }
+
+		/// <summary>
+		/// Total area of all the pages, in pixels
+		/// </summary>
+		public long PageArea { get; init; }
+
+		/// <summary>
+		/// How much of the pages are covered by packed images, from 0 to 1
+		/// </summary>
+		public float Occupancy => PageArea > 0 ? UsedArea / (float)PageArea : 0;
+
+		/// <summary>
+		/// How long packing took
+		/// </summary>
+		public TimeSpan Elapsed { get; init; }
 	}
 
 	/// <summary>
@@ -78,6 +107,18 @@ public class Packer
 	/// </summary>
 	public bool CombineDuplicates = false;
 
+	/// <summary>
+	/// The algorithm used to place images on each page
+	/// </summary>
+	public PackerMode Mode = PackerMode.Tree;
+
+	/// <summary>
+	/// Allows images to be turned 90 degrees clockwise when that fits them better.
+	/// Turned images are marked by <see cref="Entry.Rotated"/>, and must be drawn with a rotated <see cref="Subtexture"/>.
+	/// Only used by <see cref="PackerMode.MaxRects"/> and <see cref="PackerMode.Skyline"/>.
+	/// </summary>
+	public bool AllowRotation = false;
+
 	/// <summary>
 	/// The total number of source images
 	/// </summary>
@@ -86,17 +127,28 @@ public class Packer
 	private struct Source(int index, string name)
 	{
 		public int Index = index;
-		public int Hash;
+		public ulong Hash;
 		public string Name = name;
+		public Point2 Size;
 		public RectInt Packed;
 		public RectInt Frame;
 		public int BufferIndex;
 		public int BufferLength;
 		public int? DuplicateOf;
-		public readonly bool Empty => Packed.Width <= 0 || Packed.Height <= 0;
+		public int Page;
+		public bool Rotated;
+		public readonly bool Empty => Size.X <= 0 || Size.Y <= 0;
 	}
 
+	/// <summary>
+	/// A unique image stored in the source buffer, used to find duplicates.
+	/// Images with the same hash are chained together through Next.
+	/// </summary>
+	private readonly record struct Unique(int Index, int BufferIndex, int Width, int Height, int Next);
+
 	private readonly List<Source> sources = [];
+	private readonly List<Unique> uniques = [];
+	private readonly Dictionary<ulong, int> uniqueLookup = [];
 	private Color[] sourceBuffer = new Color[32];
 	private int sourceBufferIndex = 0;
 
@@ -129,99 +181,181 @@ public class Packer
 	public int Add(int index, string name, RectInt clip, int stride, ReadOnlySpan<Color> pixels)
 	{
 		var source = new Source(index, name);
-		int top = clip.Top, left = clip.Left, right = clip.Right, bottom = clip.Bottom;
+		var bounds = Trim ? TrimBounds(clip, stride, pixels) : clip;
+
+		source.Size = new Point2(bounds.Width, bounds.Height);
+		source.Frame = new RectInt(clip.Left - bounds.Left, clip.Top - bounds.Top, clip.Width, clip.Height);
+		source.BufferLength = bounds.Width * bounds.Height;
+
+		// copy our trimmed pixel data to the end of the main buffer
+		while (sourceBufferIndex + source.BufferLength >= sourceBuffer.Length)
+			Array.Resize(ref sourceBuffer, sourceBuffer.Length * 2);
+		CopyBounds(bounds, stride, pixels, sourceBuffer.AsSpan(sourceBufferIndex, source.BufferLength));
+
+		if (CombineDuplicates)
+			source.Hash = PixelKernels.Hash(sourceBuffer.AsSpan(sourceBufferIndex, source.BufferLength));
+
+		Commit(ref source, sourceBufferIndex);
+		sources.Add(source);
+		return source.Index;
+	}
+
+	/// <summary>
+	/// Adds many images at once, trimming, hashing and copying them in parallel.
+	/// Each image is given the next index, in order, exactly as if <see cref="Add(string, Image)"/> had been called for it.
+	/// The images must not be modified until this returns.
+	/// </summary>
+	public void AddRange(IReadOnlyList<(string Name, Image Image)> images)
+	{
+		var items = new (string Name, Image Image, RectInt Clip)[images.Count];
+		for (int i = 0; i < items.Length; i++)
+			items[i] = (images[i].Name, images[i].Image, new RectInt(0, 0, images[i].Image.Width, images[i].Image.Height));
+		AddRange(items);
+	}
 
-		// trim
-		if (Trim)
+	/// <summary>
+	/// Adds many clipped images at once, trimming, hashing and copying them in parallel.
+	/// Each image is given the next index, in order, exactly as if <see cref="Add(string, Image, RectInt)"/> had been called for it.
+	/// The images must not be modified until this returns.
+	/// </summary>
+	public void AddRange(IReadOnlyList<(string Name, Image Image, RectInt Clip)> images)
+	{
+		var count = images.Count;
+		var bounds = new RectInt[count];
+		var offsets = new int[count];
+		var hashes = new ulong[count];
+		var trim = Trim;
+		var combine = CombineDuplicates;
+
+		// find what each image trims down to
+		Parallel.For(0, count, i =>
 		{
-			// TOP:
-			for (int y = clip.Top; y < clip.Bottom; y++)
-				for (int x = clip.Left, s = left + y * stride; x < clip.Right; x++, s++)
-					if (pixels[s].A > 0)
-					{
-						top = y;
-						goto LEFT;
-					}
-				LEFT:
-			for (int x = clip.Left; x < clip.Right; x++)
-				for (int y = top, s = x + y * stride; y < clip.Bottom; y++, s += stride)
-					if (pixels[s].A > 0)
-					{
-						left = x;
-						goto RIGHT;
-					}
-				RIGHT:
-			for (int x = clip.Right - 1; x >= left; x--)
-				for (int y = top, s = x + y * stride; y < clip.Bottom; y++, s += stride)
-					if (pixels[s].A > 0)
-					{
-						right = x + 1;
-						goto BOTTOM;
-					}
-				BOTTOM:
-			for (int y = clip.Bottom - 1; y >= top; y--)
-				for (int x = left, s = left + y * stride; x < right; x++, s++)
-					if (pixels[s].A > 0)
-					{
-						bottom = y + 1;
-						goto END;
-					}
-				END:;
+			var (_, image, clip) = images[i];
+			bounds[i] = trim ? TrimBounds(clip, image.Width, image.Data) : clip;
+		});
+
+		// reserve the whole range at the end of the buffer, so each image has its own space to write to
+		var end = sourceBufferIndex;
+		for (int i = 0; i < count; i++)
+		{
+			offsets[i] = end;
+			end += bounds[i].Width * bounds[i].Height;
 		}
+		while (end >= sourceBuffer.Length)
+			Array.Resize(ref sourceBuffer, sourceBuffer.Length * 2);
+
+		var buffer = sourceBuffer;
+		Parallel.For(0, count, i =>
+		{
+			var (_, image, _) = images[i];
+			var data = buffer.AsSpan(offsets[i], bounds[i].Width * bounds[i].Height);
+			CopyBounds(bounds[i], image.Width, image.Data, data);
+			if (combine)
+				hashes[i] = PixelKernels.Hash(data);
+		});
 
-		// determine sizes
-		// there's a chance this image was empty in which case we have no width / height
-		if (left <= right && top <= bottom)
+		// duplicates have to be found in order, and the unique images packed down to fill the gaps they leave
+		for (int i = 0; i < count; i++)
 		{
-			if (CombineDuplicates)
+			var (name, _, clip) = images[i];
+			var source = new Source(sources.Count, name)
 			{
-				source.Hash = 0;
-				for (int x = left; x < right; x++)
-					for (int y = top; y < bottom; y++)
-						source.Hash = ((source.Hash << 5) + source.Hash) + (int)pixels[x + y * stride].RGBA;
+				Hash = hashes[i],
+				Size = new Point2(bounds[i].Width, bounds[i].Height),
+				Frame = new RectInt(clip.Left - bounds[i].Left, clip.Top - bounds[i].Top, clip.Width, clip.Height),
+				BufferLength = bounds[i].Width * bounds[i].Height,
+			};
 
-				for (int i = 0; i < sources.Count; i++)
-					if (sources[i].Hash == source.Hash)
-					{
-						source.DuplicateOf = sources[i].Index;
-						break;
-					}
-			}
+			Commit(ref source, offsets[i]);
+			sources.Add(source);
+		}
+	}
 
-			source.Packed = new RectInt(0, 0, right - left, bottom - top);
-			source.Frame = new RectInt(clip.Left - left, clip.Top - top, clip.Width, clip.Height);
+	/// <summary>
+	/// Finds the smallest rectangle within the clip that holds every visible pixel.
+	/// An image with no visible pixels keeps its whole clip.
+	/// </summary>
+	private static RectInt TrimBounds(in RectInt clip, int stride, ReadOnlySpan<Color> pixels)
+	{
+		int top = clip.Top, bottom = clip.Bottom;
 
-			if (!source.DuplicateOf.HasValue)
-			{
-				var append = source.Packed.Width * source.Packed.Height;
-				while (sourceBufferIndex + append >= sourceBuffer.Length)
-					Array.Resize(ref sourceBuffer, sourceBuffer.Length * 2);
+		// TOP:
+		while (top < bottom && PixelKernels.IndexOfVisible(pixels.Slice(clip.Left + top * stride, clip.Width)) < 0)
+			top++;
+
+		if (top >= bottom)
+			return clip;
+
+		// BOTTOM:
+		while (PixelKernels.IndexOfVisible(pixels.Slice(clip.Left + (bottom - 1) * stride, clip.Width)) < 0)
+			bottom--;
 
-				source.BufferIndex = sourceBufferIndex;
-				source.BufferLength = append;
+		// LEFT & RIGHT:
+		// scanning row by row keeps memory access linear, and each row only
+		// needs to check the columns outside of what's already been found
+		int left = clip.Width, right = 0;
+		for (int y = top; y < bottom && (left > 0 || right < clip.Width); y++)
+		{
+			var row = pixels.Slice(clip.Left + y * stride, clip.Width);
+
+			var first = PixelKernels.IndexOfVisible(row[..left]);
+			if (first >= 0)
+				left = first;
 
-				// copy our trimmed pixel data to the main buffer
-				for (int i = 0; i < source.Packed.Height; i++)
+			var last = PixelKernels.LastIndexOfVisible(row[right..]);
+			if (last >= 0)
+				right += last + 1;
+		}
+
+		return new RectInt(clip.Left + left, top, right - left, bottom - top);
+	}
+
+	private static void CopyBounds(in RectInt bounds, int stride, ReadOnlySpan<Color> pixels, Span<Color> destination)
+	{
+		for (int i = 0; i < bounds.Height; i++)
+			pixels.Slice(bounds.Left + (bounds.Top + i) * stride, bounds.Width).CopyTo(destination.Slice(i * bounds.Width, bounds.Width));
+	}
+
+	/// <summary>
+	/// Stores a source's pixels, which have been copied to the buffer at the given index, at the end of the used buffer.
+	/// If it's a duplicate of an earlier image its pixels are dropped instead.
+	/// </summary>
+	private void Commit(ref Source source, int dataIndex)
+	{
+		var length = source.BufferLength;
+		var data = sourceBuffer.AsSpan(dataIndex, length);
+		var head = -1;
+
+		if (CombineDuplicates && length > 0)
+		{
+			// a matching hash is only a candidate, the pixels must match exactly
+			head = uniqueLookup.TryGetValue(source.Hash, out var found) ? found : -1;
+			for (int i = head; i >= 0; i = uniques[i].Next)
+			{
+				var other = uniques[i];
+				if (other.Width == source.Size.X && other.Height == source.Size.Y &&
+					data.SequenceEqual(sourceBuffer.AsSpan(other.BufferIndex, length)))
 				{
-					var len = source.Packed.Width;
-					var srcIndex = left + (top + i) * stride;
-					var dstIndex = sourceBufferIndex;
-					var srcData = pixels.Slice(srcIndex, len);
-					var dstData = sourceBuffer.AsSpan(dstIndex, len);
-
-					srcData.CopyTo(dstData);
-					sourceBufferIndex += len;
+					// duplicates don't need their own copy of the pixels
+					source.DuplicateOf = other.Index;
+					source.BufferIndex = 0;
+					source.BufferLength = 0;
+					return;
 				}
 			}
 		}
-		else
+
+		if (dataIndex != sourceBufferIndex)
+			data.CopyTo(sourceBuffer.AsSpan(sourceBufferIndex, length));
+
+		source.BufferIndex = sourceBufferIndex;
+		sourceBufferIndex += length;
+
+		if (CombineDuplicates && length > 0)
 		{
-			source.Packed = new RectInt();
-			source.Frame = new RectInt(0, 0, clip.Width, clip.Height);
+			uniqueLookup[source.Hash] = uniques.Count;
+			uniques.Add(new(source.Index, source.BufferIndex, source.Size.X, source.Size.Y, head));
 		}
-
-		sources.Add(source);
-		return source.Index;
 	}
 
 	private struct PackingNode
@@ -232,21 +366,144 @@ public class Packer
 		public unsafe PackingNode* Down;
 	};
 
-	public unsafe Output Pack()
+	/// <summary>
+	/// Where a source was placed while trying to fit a page
+	/// </summary>
+	private readonly record struct Placement(int Source, RectInt Rect, bool Rotated);
+
+	/// <summary>
+	/// How much a page grows each time the remaining images don't fit on it
+	/// </summary>
+	private const float PageGrowth = 1.125f;
+
+	public Output Pack()
 	{
+		var timer = Stopwatch.StartNew();
 		Output result = new();
 
 		// Nothing to pack
 		if (sources.Count <= 0)
 			return result;
 
+		// start every source from its trimmed size, so packing again doesn't use a previous placement or rotation
+		for (int i = 0; i < sources.Count; i++)
+		{
+			var it = sources[i];
+			it.Packed = new RectInt(0, 0, it.Size.X, it.Size.Y);
+			it.Rotated = false;
+			sources[i] = it;
+		}
+
 		// sort the sources by size
-		sources.Sort((a, b) => b.Packed.Width * b.Packed.Height - a.Packed.Width * a.Packed.Height);
+		// the rectangle packers do best placing the longest sides first
+		if (Mode == PackerMode.Tree)
+			sources.Sort((a, b) => b.Packed.Width * b.Packed.Height - a.Packed.Width * a.Packed.Height);
+		else
+			sources.Sort((a, b) =>
+			{
+				var side = Math.Max(b.Packed.Width, b.Packed.Height) - Math.Max(a.Packed.Width, a.Packed.Height);
+				return side != 0 ? side : b.Packed.Width * b.Packed.Height - a.Packed.Width * a.Packed.Height;
+			});
 
 		// make sure the largest isn't too large
 		if (sources[0].Packed.Width > MaxSize || sources[0].Packed.Height > MaxSize)
 			throw new Exception("Source image is larger than max atlas size");
 
+		var padding = Math.Max(0, Padding);
+		var halfPadding = padding / 2;
+		var pageSizes = new List<Point2>();
+
+		if (Mode == PackerMode.Tree)
+			PackTree(pageSizes, padding, halfPadding);
+		else
+			PackRects(pageSizes, padding, halfPadding);
+
+		// create each page
+		long usedArea = 0, pageArea = 0;
+		for (int page = 0; page < pageSizes.Count; page++)
+		{
+			// get page size
+			int pageWidth, pageHeight;
+			if (PowerOfTwo)
+			{
+				pageWidth = 2;
+				pageHeight = 2;
+				while (pageWidth < pageSizes[page].X)
+					pageWidth *= 2;
+				while (pageHeight < pageSizes[page].Y)
+					pageHeight *= 2;
+			}
+			else
+			{
+				pageWidth = pageSizes[page].X;
+				pageHeight = pageSizes[page].Y;
+			}
+
+			var bmp = new Image(pageWidth, pageHeight);
+			result.Pages.Add(bmp);
+			pageArea += (long)pageWidth * pageHeight;
+
+			// create each entry for this page and copy its image data
+			for (int i = 0; i < sources.Count; i++)
+			{
+				var source = sources[i];
+
+				// do not pack duplicate entries yet
+				if (source.Page != page || source.Empty || source.DuplicateOf.HasValue)
+					continue;
+
+				result.Entries.Add(new(source.Index, source.Name, page, source.Packed, source.Frame, source.Rotated));
+
+				if (source.BufferLength <= 0)
+					continue;
+
+				var data = sourceBuffer.AsSpan(source.BufferIndex, source.BufferLength);
+				if (source.Rotated)
+					CopyRotated(bmp, data, source.Packed);
+				else
+					bmp.CopyPixels(data, source.Packed.Width, source.Packed.Height, source.Packed.Position);
+				usedArea += source.BufferLength;
+
+				if (DuplicateEdges && padding >= 2)
+				{
+					var p = source.Packed;
+					bmp.CopyPixels(bmp, new RectInt(p.Position, new Point2(1, p.Height)), p.Position + new Point2(-1, 0)); // L
+					bmp.CopyPixels(bmp, new RectInt(p.Position + new Point2(p.Width - 1, 0), new Point2(1, p.Height)), p.Position + new Point2(p.Width, 0)); // R
+					bmp.CopyPixels(bmp, new RectInt(p.Position + new Point2(-1, 0), new Point2(p.Width + 2, 1)), p.Position + new Point2(-1, -1)); // T
+					bmp.CopyPixels(bmp, new RectInt(p.Position + new Point2(-1, p.Height - 1), new Point2(p.Width + 2, 1)), p.Position + new Point2(-1, p.Height)); // B
+				}
+			}
+		}
+
+		// empty images take no space, but still need entries
+		foreach (var source in sources)
+		{
+			if (source.Empty && !source.DuplicateOf.HasValue)
+				result.Entries.Add(new(source.Index, source.Name, Math.Max(0, pageSizes.Count - 1), source.Packed, source.Frame));
+		}
+
+		// make sure duplicates have entries
+		if (CombineDuplicates)
+		{
+			foreach (var source in sources)
+			{
+				if (!source.DuplicateOf.HasValue)
+					continue;
+
+				foreach (var entry in result.Entries)
+					if (entry.Index == source.DuplicateOf.Value)
+					{
+						result.Entries.Add(new(source.Index, source.Name, entry.Page, entry.Source, source.Frame, entry.Rotated));
+						break;
+					}
+			}
+		}
+
+		return result with { UsedArea = usedArea, PageArea = pageArea, Elapsed = timer.Elapsed };
+	}
+
+	private unsafe void PackTree(List<Point2> pageSizes, int padding, int halfPadding)
+	{
 		// TODO: why do we sometimes need more than source images * 3?
 		// for safety I've just made it 4 ... but it should really only be 3?
 
@@ -255,16 +512,13 @@ public class Packer
 			stackalloc PackingNode[nodeCount] :
 			new PackingNode[nodeCount]);
 
-		var padding = Math.Max(0, Padding);
-		var halfPadding = padding / 2;
-
 		// using pointer operations here was faster
 		fixed (PackingNode* nodes = buffer)
 		{
-			int packed = 0, page = 0;
+			int packed = 0;
 			while (packed < sources.Count)
 			{
-				if (sources[packed].Empty)
+				if (sources[packed].Empty || sources[packed].DuplicateOf.HasValue)
 				{
 					packed++;
 					continue;
@@ -329,116 +583,446 @@ public class Packer
 					var it = sources[packed];
 					it.Packed.X = node->Rect.X + halfPadding;
 					it.Packed.Y = node->Rect.Y + halfPadding;
+					it.Page = pageSizes.Count;
 					sources[packed] = it;
 
 					packed++;
 				}
 
-				// get page size
-				int pageWidth, pageHeight;
-				if (PowerOfTwo)
-				{
-					pageWidth = 2;
-					pageHeight = 2;
-					while (pageWidth < rootPtr->Rect.Width)
-						pageWidth *= 2;
-					while (pageHeight < rootPtr->Rect.Height)
-						pageHeight *= 2;
-				}
+				pageSizes.Add(new(rootPtr->Rect.Width, rootPtr->Rect.Height));
+			}
+		}
+
+		static unsafe PackingNode* FindNode(PackingNode* root, int w, int h)
+		{
+			if (root->Used)
+			{
+				var r = FindNode(root->Right, w, h);
+				return (r != null ? r : FindNode(root->Down, w, h));
+			}
+			else if (w <= root->Rect.Width && h <= root->Rect.Height)
+			{
+				return root;
+			}
+
+			return null;
+		}
+
+		static unsafe PackingNode* ResetNode(PackingNode* node, int x, int y, int w, int h)
+		{
+			node->Used = false;
+			node->Rect = new RectInt(x, y, w, h);
+			node->Right = null;
+			node->Down = null;
+			return node;
+		}
+	}
+
+	private void PackRects(List<Point2> pageSizes, int padding, int halfPadding)
+	{
+		// sources still waiting for a page, in sorted order
+		var remaining = new List<int>();
+		for (int i = 0; i < sources.Count; i++)
+			if (!sources[i].Empty && !sources[i].DuplicateOf.HasValue)
+				remaining.Add(i);
+
+		var placed = new List<Placement>();
+		var isPlaced = new bool[sources.Count];
+
+		while (remaining.Count > 0)
+		{
+			long area = 0;
+			int largestWidth = 0, largestHeight = 0;
+			foreach (var index in remaining)
+			{
+				var w = sources[index].Packed.Width + padding;
+				var h = sources[index].Packed.Height + padding;
+				area += (long)w * h;
+				largestWidth = Math.Max(largestWidth, w);
+				largestHeight = Math.Max(largestHeight, h);
+			}
+
+			// the largest image (with its padding) always fits on a page, even if it's exactly MaxSize
+			var maxWidth = Math.Max(MaxSize, largestWidth);
+			var maxHeight = Math.Max(MaxSize, largestHeight);
+
+			// start with the smallest square that could hold everything,
+			// and grow it until everything fits or the page is as large as it can be
+			var side = (int)Math.Ceiling(Math.Sqrt(area));
+			var width = Math.Min(maxWidth, Math.Max(side, largestWidth));
+			var height = Math.Min(maxHeight, Math.Max(side, largestHeight));
+
+			while (true)
+			{
+				placed.Clear();
+				if (Mode == PackerMode.MaxRects)
+					PlaceMaxRects(remaining, width, height, padding, placed);
 				else
-				{
-					pageWidth = rootPtr->Rect.Width;
-					pageHeight = rootPtr->Rect.Height;
-				}
+					PlaceSkyline(remaining, width, height, padding, placed);
 
-				// create each page
-				{
-					var bmp = new Image(pageWidth, pageHeight);
-					result.Pages.Add(bmp);
+				if (placed.Count >= remaining.Count || (width >= maxWidth && height >= maxHeight))
+					break;
 
-					// create each entry for this page and copy its image data
-					for (int i = from; i < packed; i++)
-					{
-						var source = sources[i];
+				if ((width <= height && width < maxWidth) || height >= maxHeight)
+					width = Math.Min(maxWidth, Math.Max(width + 1, (int)(width * PageGrowth)));
+				else
+					height = Math.Min(maxHeight, Math.Max(height + 1, (int)(height * PageGrowth)));
+			}
 
-						// do not pack duplicate entries yet
-						if (source.DuplicateOf.HasValue)
-							continue;
+			// assign the placements, and shrink the page to what was used
+			int pageWidth = 0, pageHeight = 0;
+			foreach (var placement in placed)
+			{
+				var it = sources[placement.Source];
+				var rect = placement.Rect;
+				it.Packed = new RectInt(rect.X + halfPadding, rect.Y + halfPadding, rect.Width - padding, rect.Height - padding);
+				it.Rotated = placement.Rotated;
+				it.Page = pageSizes.Count;
+				sources[placement.Source] = it;
+				isPlaced[placement.Source] = true;
 
-						result.Entries.Add(new(source.Index, source.Name, page, source.Packed, source.Frame));
+				pageWidth = Math.Max(pageWidth, rect.Right);
+				pageHeight = Math.Max(pageHeight, rect.Bottom);
+			}
 
-						if (source.Empty || source.BufferLength <= 0)
-							continue;
+			pageSizes.Add(new(pageWidth, pageHeight));
+			remaining.RemoveAll(it => isPlaced[it]);
+		}
+	}
 
-						var data = sourceBuffer.AsSpan(source.BufferIndex, source.BufferLength);
-						bmp.CopyPixels(data, source.Packed.Width, source.Packed.Height, source.Packed.Position);
+	private bool CanRotate(int index)
+	{
+		return AllowRotation && sources[index].Packed.Width != sources[index].Packed.Height;
+	}
 
-						if (DuplicateEdges && padding >= 2)
-						{
-							var p = source.Packed;
-							bmp.CopyPixels(bmp, new RectInt(p.Position, new Point2(1, p.Height)), p.Position + new Point2(-1, 0)); // L
-							bmp.CopyPixels(bmp, new RectInt(p.Position + new Point2(p.Width - 1, 0), new Point2(1, p.Height)), p.Position + new Point2(p.Width, 0)); // R
-							bmp.CopyPixels(bmp, new RectInt(p.Position + new Point2(-1, 0), new Point2(p.Width + 2, 1)), p.Position + new Point2(-1, -1)); // T
-							bmp.CopyPixels(bmp, new RectInt(p.Position + new Point2(-1, p.Height - 1), new Point2(p.Width + 2, 1)), p.Position + new Point2(-1, p.Height)); // B
-						}
+	private void PlaceMaxRects(List<int> remaining, int width, int height, int padding, List<Placement> placed)
+	{
+		var bin = new MaxRectsBin(width, height);
+
+		foreach (var index in remaining)
+		{
+			var w = sources[index].Packed.Width + padding;
+			var h = sources[index].Packed.Height + padding;
+			if (bin.TryInsert(w, h, CanRotate(index), out var rect, out var rotated))
+				placed.Add(new(index, rect, rotated));
+		}
+	}
+
+	private void PlaceSkyline(List<int> remaining, int width, int height, int padding, List<Placement> placed)
+	{
+		// each segment of the skyline is the top edge of everything placed beneath it, left to right
+		var skyline = new List<(int X, int Y, int Width)> { (0, 0, width) };
+
+		foreach (var index in remaining)
+		{
+			var w = sources[index].Packed.Width + padding;
+			var h = sources[index].Packed.Height + padding;
+			var rotate = CanRotate(index);
+
+			// bottom-left: the position that keeps the top of the image lowest, preferring narrower segments
+			int bestSegment = -1, bestBottom = int.MaxValue, bestWidth = int.MaxValue;
+			RectInt best = default;
+			bool rotated = false;
+
+			for (int i = 0; i < skyline.Count; i++)
+			{
+				for (int turn = 0; turn < (rotate ? 2 : 1); turn++)
+				{
+					var rw = turn == 0 ? w : h;
+					var rh = turn == 0 ? h : w;
+					if (!Fits(skyline, i, rw, rh, width, height, out var y))
+						continue;
+
+					var bottom = y + rh;
+					if (bottom < bestBottom || (bottom == bestBottom && skyline[i].Width < bestWidth))
+					{
+						bestSegment = i;
+						bestBottom = bottom;
+						bestWidth = skyline[i].Width;
+						best = new RectInt(skyline[i].X, y, rw, rh);
+						rotated = turn == 1;
 					}
 				}
+			}
+
+			if (bestSegment < 0)
+				continue;
+
+			placed.Add(new(index, best, rotated));
+			AddLevel(skyline, bestSegment, best);
+		}
 
-				page++;
+		static bool Fits(List<(int X, int Y, int Width)> skyline, int index, int w, int h, int width, int height, out int y)
+		{
+			y = 0;
+			if (skyline[index].X + w > width)
+				return false;
+
+			// the image rests on the highest segment beneath it
+			for (int i = index, remaining = w; remaining > 0; i++)
+			{
+				y = Math.Max(y, skyline[i].Y);
+				if (y + h > height)
+					return false;
+				remaining -= skyline[i].Width;
 			}
 
+			return true;
 		}
 
-		// make sure duplicates have entries
-		if (CombineDuplicates)
+		static void AddLevel(List<(int X, int Y, int Width)> skyline, int index, in RectInt rect)
 		{
-			foreach (var source in sources)
+			skyline.Insert(index, (rect.X, rect.Bottom, rect.Width));
+
+			// cut away the segments now hidden beneath the new one
+			for (int i = index + 1; i < skyline.Count;)
 			{
-				if (!source.DuplicateOf.HasValue)
+				var prev = skyline[i - 1];
+				var it = skyline[i];
+				var overlap = prev.X + prev.Width - it.X;
+				if (overlap <= 0)
+					break;
+
+				if (it.Width <= overlap)
+				{
+					skyline.RemoveAt(i);
 					continue;
+				}
 
-				foreach (var entry in result.Entries)
-					if (entry.Index == source.DuplicateOf.Value)
-					{
-						result.Entries.Add(new(source.Index, source.Name, entry.Page, entry.Source, source.Frame));
-						break;
-					}
+				skyline[i] = (it.X + overlap, it.Y, it.Width - overlap);
+				break;
+			}
+
+			// join neighbours at the same height
+			for (int i = 0; i < skyline.Count - 1; i++)
+			{
+				if (skyline[i].Y == skyline[i + 1].Y)
+				{
+					skyline[i] = (skyline[i].X, skyline[i].Y, skyline[i].Width + skyline[i + 1].Width);
+					skyline.RemoveAt(i + 1);
+					i--;
+				}
 			}
 		}
+	}
 
-		return result;
+	/// <summary>
+	/// Copies an image onto the page turned 90 degrees clockwise, so it fills the given (turned) rectangle
+	/// </summary>
+	private static void CopyRotated(Image page, ReadOnlySpan<Color> data, in RectInt dest)
+	{
+		var pixels = page.Data;
+		int w = dest.Height, h = dest.Width;
+		for (int y = 0; y < h; y++)
+		{
+			var column = dest.X + h - 1 - y;
+			for (int x = 0; x < w; x++)
+				pixels[column + (dest.Y + x) * page.Width] = data[x + y * w];
+		}
+	}
 
-		static unsafe PackingNode* FindNode(PackingNode* root, int w, int h)
+	/// <summary>
+	/// Version of the binary format written by <see cref="PackCached(string)"/>.
+	/// Bump this whenever the format or the way sources are packed changes, so cached files are rebuilt.
+	/// </summary>
+	private const int CacheVersion = 1;
+
+	private static ReadOnlySpan<byte> CacheMagic => "FPAK"u8;
+
+	/// <summary>
+	/// Loads the packed pages and entries from a cache file in the given directory, which skips packing entirely.
+	/// If there is no cache file for these exact sources and settings, or it is unreadable,
+	/// the sources are packed with <see cref="Pack"/> and a new cache file is written.
+	/// </summary>
+	public Output PackCached(string cacheDirectory)
+	{
+		var timer = Stopwatch.StartNew();
+		var key = GetCacheKey();
+		var cachePath = Path.Combine(cacheDirectory, $"{Convert.ToHexString(key, 0, 16)}.atlas");
+
+		// try loading the existing cache file
+		if (File.Exists(cachePath))
 		{
-			if (root->Used)
+			try
 			{
-				var r = FindNode(root->Right, w, h);
-				return (r != null ? r : FindNode(root->Down, w, h));
+				using var stream = File.OpenRead(cachePath);
+				if (TryReadCache(stream, key, out var cached))
+					return cached with { Elapsed = timer.Elapsed };
 			}
-			else if (w <= root->Rect.Width && h <= root->Rect.Height)
+			catch (Exception e)
 			{
-				return root;
+				Log.Warning($"Failed to read Packer cache '{cachePath}': {e.Message}");
 			}
+		}
 
-			return null;
+		// otherwise pack it
+		var result = Pack();
+
+		// write to a uniquely named temporary file first, so a partially written cache is never loaded
+		// and other processes packing the same sources don't write over each other
+		var tempPath = $"{cachePath}.{Guid.NewGuid():N}.tmp";
+		try
+		{
+			Directory.CreateDirectory(cacheDirectory);
+			using (var stream = File.Create(tempPath))
+				WriteCache(stream, key, result);
+			File.Move(tempPath, cachePath, true);
+		}
+		catch (Exception e)
+		{
+			Log.Warning($"Failed to write Packer cache '{cachePath}': {e.Message}");
+			try { File.Delete(tempPath); } catch { }
 		}
 
-		static unsafe PackingNode* ResetNode(PackingNode* node, int x, int y, int w, int h)
+		return result;
+	}
+
+	private static void WriteCache(Stream stream, ReadOnlySpan<byte> key, in Output output)
+	{
+		using var writer = new BinaryWriter(stream, Encoding.UTF8, true);
+
+		// header
+		writer.Write(CacheMagic);
+		writer.Write(CacheVersion);
+		writer.Write(key.Length);
+		writer.Write(key);
+		writer.Write(output.UsedArea);
+		writer.Write(output.PageArea);
+
+		// pages as QOI images
+		writer.Write(output.Pages.Count);
+		foreach (var page in output.Pages)
 		{
-			node->Used = false;
-			node->Rect = new RectInt(x, y, w, h);
-			node->Right = null;
-			node->Down = null;
-			return node;
+			using var encoded = new MemoryStream();
+			page.WriteQoi(encoded);
+			writer.Write((int)encoded.Length);
+			writer.Write(encoded.GetBuffer(), 0, (int)encoded.Length);
+		}
+
+		// entries
+		writer.Write(output.Entries.Count);
+		foreach (var entry in output.Entries)
+		{
+			writer.Write(entry.Index);
+			writer.Write(entry.Name);
+			writer.Write(entry.Page);
+			writer.Write(entry.Source.X);
+			writer.Write(entry.Source.Y);
+			writer.Write(entry.Source.Width);
+			writer.Write(entry.Source.Height);
+			writer.Write(entry.Frame.X);
+			writer.Write(entry.Frame.Y);
+			writer.Write(entry.Frame.Width);
+			writer.Write(entry.Frame.Height);
+			writer.Write(entry.Rotated);
 		}
 	}
 
+	private static bool TryReadCache(Stream stream, ReadOnlySpan<byte> expectedKey, out Output result)
+	{
+		result = new();
+
+		using var reader = new BinaryReader(stream, Encoding.UTF8, true);
+
+		// header
+		Span<byte> magic = stackalloc byte[4];
+		if (reader.Read(magic) != magic.Length || !magic.SequenceEqual(CacheMagic))
+			return false;
+		if (reader.ReadInt32() != CacheVersion)
+			return false;
+
+		var key = reader.ReadBytes(reader.ReadInt32());
+		if (!key.AsSpan().SequenceEqual(expectedKey))
+			return false;
+
+		var output = new Output
+		{
+			UsedArea = reader.ReadInt64(),
+			PageArea = reader.ReadInt64(),
+		};
+
+		try
+		{
+			// pages
+			var pageCount = reader.ReadInt32();
+			for (int i = 0; i < pageCount; i++)
+			{
+				var encoded = reader.ReadBytes(reader.ReadInt32());
+				output.Pages.Add(new Image(new MemoryStream(encoded)));
+			}
+
+			// entries
+			var entryCount = reader.ReadInt32();
+			for (int i = 0; i < entryCount; i++)
+			{
+				var index = reader.ReadInt32();
+				var name = reader.ReadString();
+				var page = reader.ReadInt32();
+				var source = new RectInt(reader.ReadInt32(), reader.ReadInt32(), reader.ReadInt32(), reader.ReadInt32());
+				var frame = new RectInt(reader.ReadInt32(), reader.ReadInt32(), reader.ReadInt32(), reader.ReadInt32());
+				var rotated = reader.ReadBoolean();
+				output.Entries.Add(new(index, name, page, source, frame, rotated));
+			}
+		}
+		catch
+		{
+			// don't leave the pages that did load to the finalizer
+			foreach (var page in output.Pages)
+				page.Dispose();
+			throw;
+		}
+
+		result = output;
+		return true;
+	}
+
+	/// <summary>
+	/// Hash of every source and setting that affects the packed result, used to find its cache file.
+	/// Source pixels are hashed with XXH64 and only their hashes are fed to the final SHA-256.
+	/// </summary>
+	private byte[] GetCacheKey()
+	{
+		using var hash = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+		hash.AppendData(BitConverter.GetBytes(CacheVersion));
+		hash.AppendData(BitConverter.GetBytes(Trim));
+		hash.AppendData(BitConverter.GetBytes(MaxSize));
+		hash.AppendData(BitConverter.GetBytes(PowerOfTwo));
+		hash.AppendData(BitConverter.GetBytes(DuplicateEdges));
+		hash.AppendData(BitConverter.GetBytes(Padding));
+		hash.AppendData(BitConverter.GetBytes(CombineDuplicates));
+		hash.AppendData(BitConverter.GetBytes((int)Mode));
+		hash.AppendData(BitConverter.GetBytes(AllowRotation));
+
+		// packing reorders the sources, so go through them in the order they were added
+		foreach (var source in sources.OrderBy(it => it.Index))
+		{
+			// duplicates have no pixels of their own, and are identified by the source they duplicate
+			var pixels = PixelKernels.Hash(sourceBuffer.AsSpan(source.BufferIndex, source.BufferLength));
+
+			hash.AppendData(BitConverter.GetBytes(source.Index));
+			hash.AppendData(BitConverter.GetBytes(source.Name.Length));
+			hash.AppendData(Encoding.UTF8.GetBytes(source.Name));
+			hash.AppendData(BitConverter.GetBytes(source.Size.X));
+			hash.AppendData(BitConverter.GetBytes(source.Size.Y));
+			hash.AppendData(BitConverter.GetBytes(source.Frame.X));
+			hash.AppendData(BitConverter.GetBytes(source.Frame.Y));
+			hash.AppendData(BitConverter.GetBytes(source.Frame.Width));
+			hash.AppendData(BitConverter.GetBytes(source.Frame.Height));
+			hash.AppendData(BitConverter.GetBytes(source.DuplicateOf ?? -1));
+			hash.AppendData(BitConverter.GetBytes(pixels));
+		}
+
+		return hash.GetHashAndReset();
+	}
+
 	/// <summary>
 	/// Removes all source data and removes the Packed Output
 	/// </summary>
 	public void Clear()
 	{
 		sources.Clear();
+		uniques.Clear();
+		uniqueLookup.Clear();
 		sourceBufferIndex = 0;
 	}
 }
@@ -0,0 +1,581 @@
+using System.Diagnostics;
+using System.Numerics;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Runtime.Intrinsics;
+using System.Runtime.Intrinsics.X86;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// Vectorized operations over spans of pixels.
+/// Colors are processed 8 at a time as packed 32-bit values, with R in the lowest byte.
+/// </summary>
+internal static class PixelKernels
+{
+	private static Vector256<uint> ByteMask => Vector256.Create(0xFFu);
+
+	/// <summary>
+	/// floor(t / 255), exact for any t up to 255 * 255
+	/// </summary>
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<uint> Div255(Vector256<uint> t)
+		=> (t + Vector256<uint>.One + (t >> 8)) >> 8;
+
+	/// <summary>
+	/// round(a * b / 255)
+	/// </summary>
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<uint> Mul(Vector256<uint> a, Vector256<uint> b)
+	{
+		var t = a * b + Vector256.Create(0x80u);
+		return ((t >> 8) + t) >> 8;
+	}
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static int Mul(int a, int b)
+	{
+		var t = a * b + 0x80;
+		return ((t >> 8) + t) >> 8;
+	}
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<uint> Channel(Vector256<uint> p, int channel)
+		=> (p >> (channel * 8)) & ByteMask;
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<uint> Pack(Vector256<uint> r, Vector256<uint> g, Vector256<uint> b, Vector256<uint> a)
+		=> r | (g << 8) | (b << 16) | (a << 24);
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<uint> Load(Span<uint> data, int index)
+		=> Vector256.LoadUnsafe(ref MemoryMarshal.GetReference(data), (nuint)index);
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<uint> Load(ReadOnlySpan<uint> data, int index)
+		=> Vector256.LoadUnsafe(ref MemoryMarshal.GetReference(data), (nuint)index);
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static void Store(Vector256<uint> value, Span<uint> data, int index)
+		=> value.StoreUnsafe(ref MemoryMarshal.GetReference(data), (nuint)index);
+
+	/// <summary>
+	/// Premultiplies every pixel by its alpha. Matches <see cref="Color.Premultiply"/>.
+	/// </summary>
+	public static void Premultiply(Span<Color> pixels)
+	{
+		var data = MemoryMarshal.Cast<Color, uint>(pixels);
+		var i = 0;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			for (; i + 8 <= data.Length; i += 8)
+			{
+				var p = Load(data, i);
+				var a = p >> 24;
+				var r = Div255(Channel(p, 0) * a);
+				var g = Div255(Channel(p, 1) * a);
+				var b = Div255(Channel(p, 2) * a);
+				Store(Pack(r, g, b, a), data, i);
+			}
+		}
+
+		for (; i < pixels.Length; i++)
+			pixels[i] = pixels[i].Premultiply();
+	}
+
+	/// <summary>
+	/// Blends premultiplied source pixels onto premultiplied destination pixels of the same length
+	/// </summary>
+	public static void Blend(ReadOnlySpan<Color> source, Span<Color> destination, PixelBlend blend, byte opacity)
+	{
+		if (blend == PixelBlend.Copy && opacity == 255)
+		{
+			source.CopyTo(destination);
+			return;
+		}
+
+		var src = MemoryMarshal.Cast<Color, uint>(source);
+		var dst = MemoryMarshal.Cast<Color, uint>(destination);
+		var i = 0;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			var o = Vector256.Create((uint)opacity);
+			var max = Vector256.Create(255u);
+
+			for (; i + 8 <= src.Length; i += 8)
+			{
+				var s = Load(src, i);
+				var d = Load(dst, i);
+
+				var sr = Channel(s, 0);
+				var sg = Channel(s, 1);
+				var sb = Channel(s, 2);
+				var sa = Channel(s, 3);
+				if (opacity != 255)
+				{
+					sr = Mul(sr, o);
+					sg = Mul(sg, o);
+					sb = Mul(sb, o);
+					sa = Mul(sa, o);
+				}
+
+				if (blend == PixelBlend.Copy)
+				{
+					Store(Pack(sr, sg, sb, sa), dst, i);
+					continue;
+				}
+
+				var dr = Channel(d, 0);
+				var dg = Channel(d, 1);
+				var db = Channel(d, 2);
+				var da = Channel(d, 3);
+				Vector256<uint> r, g, b, a;
+
+				switch (blend)
+				{
+					case PixelBlend.Normal:
+					{
+						var inv = max - sa;
+						r = sr + Mul(dr, inv);
+						g = sg + Mul(dg, inv);
+						b = sb + Mul(db, inv);
+						a = sa + Mul(da, inv);
+						break;
+					}
+					case PixelBlend.Additive:
+					{
+						r = sr + dr;
+						g = sg + dg;
+						b = sb + db;
+						a = sa + da;
+						break;
+					}
+					default:
+					{
+						var invS = max - sa;
+						var invD = max - da;
+						r = Mul(sr, dr) + Mul(sr, invD) + Mul(dr, invS);
+						g = Mul(sg, dg) + Mul(sg, invD) + Mul(dg, invS);
+						b = Mul(sb, db) + Mul(sb, invD) + Mul(db, invS);
+						a = sa + Mul(da, invS);
+						break;
+					}
+				}
+
+				Store(Pack(
+					Vector256.Min(r, max),
+					Vector256.Min(g, max),
+					Vector256.Min(b, max),
+					Vector256.Min(a, max)), dst, i);
+			}
+		}
+
+		for (; i < source.Length; i++)
+			destination[i] = Blend(source[i], destination[i], blend, opacity);
+	}
+
+	/// <summary>
+	/// Blends a single premultiplied pixel. Matches the results of the vectorized path.
+	/// </summary>
+	public static Color Blend(Color s, Color d, PixelBlend blend, byte opacity)
+	{
+		int sr = s.R, sg = s.G, sb = s.B, sa = s.A;
+		if (opacity != 255)
+		{
+			sr = Mul(sr, opacity);
+			sg = Mul(sg, opacity);
+			sb = Mul(sb, opacity);
+			sa = Mul(sa, opacity);
+		}
+
+		int r, g, b, a;
+		switch (blend)
+		{
+			case PixelBlend.Copy:
+				return new Color((byte)sr, (byte)sg, (byte)sb, (byte)sa);
+
+			case PixelBlend.Normal:
+			{
+				var inv = 255 - sa;
+				r = sr + Mul(d.R, inv);
+				g = sg + Mul(d.G, inv);
+				b = sb + Mul(d.B, inv);
+				a = sa + Mul(d.A, inv);
+				break;
+			}
+			case PixelBlend.Additive:
+			{
+				r = sr + d.R;
+				g = sg + d.G;
+				b = sb + d.B;
+				a = sa + d.A;
+				break;
+			}
+			default:
+			{
+				var invS = 255 - sa;
+				var invD = 255 - d.A;
+				r = Mul(sr, d.R) + Mul(sr, invD) + Mul(d.R, invS);
+				g = Mul(sg, d.G) + Mul(sg, invD) + Mul(d.G, invS);
+				b = Mul(sb, d.B) + Mul(sb, invD) + Mul(d.B, invS);
+				a = sa + Mul(d.A, invS);
+				break;
+			}
+		}
+
+		return new Color(
+			(byte)Math.Min(r, 255),
+			(byte)Math.Min(g, 255),
+			(byte)Math.Min(b, 255),
+			(byte)Math.Min(a, 255));
+	}
+
+	/// <summary>
+	/// Rearranges the channels of every pixel, where each output channel is read from the given input channel
+	/// </summary>
+	public static void Swizzle(Span<Color> pixels, ColorChannel r, ColorChannel g, ColorChannel b, ColorChannel a)
+	{
+		var data = MemoryMarshal.Cast<Color, uint>(pixels);
+		var i = 0;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			for (; i + 8 <= data.Length; i += 8)
+			{
+				var p = Load(data, i);
+				Store(Pack(Channel(p, (int)r), Channel(p, (int)g), Channel(p, (int)b), Channel(p, (int)a)), data, i);
+			}
+		}
+
+		for (; i < data.Length; i++)
+		{
+			var p = data[i];
+			data[i] =
+				((p >> ((int)r * 8)) & 0xFF) |
+				(((p >> ((int)g * 8)) & 0xFF) << 8) |
+				(((p >> ((int)b * 8)) & 0xFF) << 16) |
+				(((p >> ((int)a * 8)) & 0xFF) << 24);
+		}
+	}
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<uint> Luminance(Vector256<uint> p)
+		=> (Channel(p, 0) * Vector256.Create(77u) + Channel(p, 1) * Vector256.Create(150u) + Channel(p, 2) * Vector256.Create(29u) + Vector256.Create(128u)) >> 8;
+
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static uint Luminance(uint p)
+		=> ((p & 0xFF) * 77 + ((p >> 8) & 0xFF) * 150 + ((p >> 16) & 0xFF) * 29 + 128) >> 8;
+
+	/// <summary>
+	/// Converts every pixel to grayscale using its luminance, keeping alpha
+	/// </summary>
+	public static void Grayscale(Span<Color> pixels)
+	{
+		var data = MemoryMarshal.Cast<Color, uint>(pixels);
+		var i = 0;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			for (; i + 8 <= data.Length; i += 8)
+			{
+				var p = Load(data, i);
+				var l = Luminance(p);
+				Store(Pack(l, l, l, p >> 24), data, i);
+			}
+		}
+
+		for (; i < data.Length; i++)
+		{
+			var l = Luminance(data[i]);
+			data[i] = l | (l << 8) | (l << 16) | (data[i] & 0xFF000000);
+		}
+	}
+
+	/// <summary>
+	/// Writes a single channel of every pixel to the destination, or the luminance if channel is null
+	/// </summary>
+	public static void ToR8(ReadOnlySpan<Color> pixels, Span<byte> destination, ColorChannel? channel)
+	{
+		var data = MemoryMarshal.Cast<Color, uint>(pixels);
+		var i = 0;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			for (; i + 32 <= data.Length; i += 32)
+			{
+				var v0 = Load(data, i + 0);
+				var v1 = Load(data, i + 8);
+				var v2 = Load(data, i + 16);
+				var v3 = Load(data, i + 24);
+
+				if (channel is ColorChannel c)
+				{
+					v0 = Channel(v0, (int)c);
+					v1 = Channel(v1, (int)c);
+					v2 = Channel(v2, (int)c);
+					v3 = Channel(v3, (int)c);
+				}
+				else
+				{
+					v0 = Luminance(v0);
+					v1 = Luminance(v1);
+					v2 = Luminance(v2);
+					v3 = Luminance(v3);
+				}
+
+				var bytes = Vector256.Narrow(Vector256.Narrow(v0, v1), Vector256.Narrow(v2, v3));
+				bytes.StoreUnsafe(ref MemoryMarshal.GetReference(destination), (nuint)i);
+			}
+		}
+
+		for (; i < data.Length; i++)
+		{
+			destination[i] = channel is ColorChannel c
+				? (byte)(data[i] >> ((int)c * 8))
+				: (byte)Luminance(data[i]);
+		}
+	}
+
+	/// <summary>
+	/// Expands single channel values to gray pixels.
+	/// If valueIsAlpha is true the pixels are (v, v, v, v), which is premultiplied white coverage,
+	/// otherwise they are opaque (v, v, v, 255).
+	/// </summary>
+	public static void FromR8(ReadOnlySpan<byte> values, Span<Color> destination, bool valueIsAlpha)
+	{
+		var data = MemoryMarshal.Cast<Color, uint>(destination);
+		var i = 0;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			var spread = Vector256.Create(valueIsAlpha ? 0x01010101u : 0x00010101u);
+			var alpha = Vector256.Create(valueIsAlpha ? 0u : 0xFF000000u);
+
+			for (; i + 32 <= values.Length; i += 32)
+			{
+				var bytes = Vector256.LoadUnsafe(ref MemoryMarshal.GetReference(values), (nuint)i);
+				var (lo, hi) = Vector256.Widen(bytes);
+				var (v0, v1) = Vector256.Widen(lo);
+				var (v2, v3) = Vector256.Widen(hi);
+				Store(v0 * spread | alpha, data, i + 0);
+				Store(v1 * spread | alpha, data, i + 8);
+				Store(v2 * spread | alpha, data, i + 16);
+				Store(v3 * spread | alpha, data, i + 24);
+			}
+		}
+
+		for (; i < values.Length; i++)
+		{
+			var v = values[i];
+			destination[i] = new Color(v, v, v, valueIsAlpha ? v : (byte)255);
+		}
+	}
+
+	/// <summary>
+	/// Expands pairs of (value, alpha) bytes, as stored by grayscale Aseprite files, to Colors
+	/// </summary>
+	public static unsafe void FromGrayscaleAlpha(ReadOnlySpan<byte> values, Span<Color> destination)
+	{
+		var pairs = MemoryMarshal.Cast<byte, ushort>(values);
+		var i = 0;
+
+		// zero-extending loads are much faster than Vector256.Widen here
+		if (Avx2.IsSupported)
+		{
+			var data = MemoryMarshal.Cast<Color, uint>(destination);
+			fixed (ushort* pair = pairs)
+			{
+				for (; i + 8 <= pairs.Length; i += 8)
+				{
+					var p = Avx2.ConvertToVector256Int32(pair + i).AsUInt32();
+					var v = p & ByteMask;
+					Store(v | v << 8 | v << 16 | (p >> 8) << 24, data, i);
+				}
+			}
+		}
+
+		for (; i < pairs.Length; i++)
+		{
+			var v = (byte)pairs[i];
+			destination[i] = new Color(v, v, v, (byte)(pairs[i] >> 8));
+		}
+	}
+
+	/// <summary>
+	/// Looks up each index in the palette, which must have 256 entries
+	/// </summary>
+	public static unsafe void FromIndexed(ReadOnlySpan<byte> indices, ReadOnlySpan<Color> palette, Span<Color> destination)
+	{
+		Debug.Assert(palette.Length >= 256);
+
+		var i = 0;
+
+		if (Avx2.IsSupported)
+		{
+			var data = MemoryMarshal.Cast<Color, uint>(destination);
+			fixed (byte* index = indices)
+			fixed (Color* colors = palette)
+			{
+				for (; i + 8 <= indices.Length; i += 8)
+					Store(Avx2.GatherVector256((uint*)colors, Avx2.ConvertToVector256Int32(index + i), 4), data, i);
+			}
+		}
+
+		for (; i < indices.Length; i++)
+			destination[i] = palette[indices[i]];
+	}
+
+	/// <summary>
+	/// Index of the first pixel with any alpha, or -1 if every pixel is fully transparent
+	/// </summary>
+	public static int IndexOfVisible(ReadOnlySpan<Color> pixels)
+	{
+		var data = MemoryMarshal.Cast<Color, uint>(pixels);
+		var i = 0;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			var transparent = Vector256.Create(0x00FFFFFFu);
+			for (; i + 8 <= data.Length; i += 8)
+			{
+				var visible = Vector256.GreaterThan(Load(data, i), transparent).ExtractMostSignificantBits();
+				if (visible != 0)
+					return i + BitOperations.TrailingZeroCount(visible);
+			}
+		}
+
+		for (; i < pixels.Length; i++)
+			if (pixels[i].A > 0)
+				return i;
+
+		return -1;
+	}
+
+	/// <summary>
+	/// Index of the last pixel with any alpha, or -1 if every pixel is fully transparent
+	/// </summary>
+	public static int LastIndexOfVisible(ReadOnlySpan<Color> pixels)
+	{
+		var data = MemoryMarshal.Cast<Color, uint>(pixels);
+		var i = data.Length;
+
+		if (Vector256.IsHardwareAccelerated)
+		{
+			var transparent = Vector256.Create(0x00FFFFFFu);
+			for (; i >= 8; i -= 8)
+			{
+				var visible = Vector256.GreaterThan(Load(data, i - 8), transparent).ExtractMostSignificantBits();
+				if (visible != 0)
+					return i - 8 + 31 - BitOperations.LeadingZeroCount(visible);
+			}
+		}
+
+		for (i--; i >= 0; i--)
+			if (pixels[i].A > 0)
+				return i;
+
+		return -1;
+	}
+
+	private const ulong Prime1 = 0x9E3779B185EBCA87UL;
+	private const ulong Prime2 = 0xC2B2AE3D27D4EB4FUL;
+	private const ulong Prime3 = 0x165667B19E3779F9UL;
+	private const ulong Prime4 = 0x85EBCA77C2B2AE63UL;
+	private const ulong Prime5 = 0x27D4EB2F165667C5UL;
+
+	/// <summary>
+	/// The 64-bit xxHash (XXH64) of the pixel bytes.
+	/// The 4 accumulator lanes are processed together with AVX2 when available,
+	/// and the result is the same on every platform, so it can be stored.
+	/// </summary>
+	public static ulong Hash(ReadOnlySpan<Color> pixels, ulong seed = 0)
+	{
+		var data = MemoryMarshal.AsBytes(pixels);
+		var longs = MemoryMarshal.Cast<byte, ulong>(data);
+		var length = (ulong)data.Length;
+		var i = 0;
+		ulong hash;
+
+		if (data.Length >= 32)
+		{
+			ulong v1, v2, v3, v4;
+
+			if (Avx2.IsSupported)
+			{
+				var acc = Vector256.Create(seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1);
+				for (; i + 4 <= longs.Length; i += 4)
+				{
+					var input = Vector256.LoadUnsafe(ref MemoryMarshal.GetReference(longs), (nuint)i);
+					acc += Mul64(input, Prime2);
+					acc = (acc << 31) | (acc >> 33);
+					acc = Mul64(acc, Prime1);
+				}
+				(v1, v2, v3, v4) = (acc[0], acc[1], acc[2], acc[3]);
+			}
+			else
+			{
+				(v1, v2, v3, v4) = (seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1);
+				for (; i + 4 <= longs.Length; i += 4)
+				{
+					v1 = Round(v1, longs[i + 0]);
+					v2 = Round(v2, longs[i + 1]);
+					v3 = Round(v3, longs[i + 2]);
+					v4 = Round(v4, longs[i + 3]);
+				}
+			}
+
+			hash = BitOperations.RotateLeft(v1, 1) + BitOperations.RotateLeft(v2, 7) +
+				BitOperations.RotateLeft(v3, 12) + BitOperations.RotateLeft(v4, 18);
+			hash = MergeRound(hash, v1);
+			hash = MergeRound(hash, v2);
+			hash = MergeRound(hash, v3);
+			hash = MergeRound(hash, v4);
+		}
+		else
+		{
+			hash = seed + Prime5;
+		}
+
+		hash += length;
+
+		for (; i < longs.Length; i++)
+			hash = BitOperations.RotateLeft(hash ^ Round(0, longs[i]), 27) * Prime1 + Prime4;
+
+		// a single pixel may be left over, as pixels are only 4 bytes
+		if ((data.Length & 7) != 0)
+		{
+			var last = MemoryMarshal.Read<uint>(data[^4..]);
+			hash = BitOperations.RotateLeft(hash ^ (last * Prime1), 23) * Prime2 + Prime3;
+		}
+
+		hash ^= hash >> 33;
+		hash *= Prime2;
+		hash ^= hash >> 29;
+		hash *= Prime3;
+		hash ^= hash >> 32;
+		return hash;
+
+		[MethodImpl(MethodImplOptions.AggressiveInlining)]
+		static ulong Round(ulong acc, ulong input)
+			=> BitOperations.RotateLeft(acc + input * Prime2, 31) * Prime1;
+
+		[MethodImpl(MethodImplOptions.AggressiveInlining)]
+		static ulong MergeRound(ulong acc, ulong value)
+			=> (acc ^ Round(0, value)) * Prime1 + Prime4;
+	}
+
+	/// <summary>
+	/// The low 64 bits of a * b in each lane, built from 32-bit multiplies as AVX2 has no 64-bit multiply
+	/// </summary>
+	[MethodImpl(MethodImplOptions.AggressiveInlining)]
+	private static Vector256<ulong> Mul64(Vector256<ulong> a, ulong b)
+	{
+		var bLo = Vector256.Create(b & 0xFFFFFFFF).AsUInt32();
+		var bHi = Vector256.Create(b >> 32).AsUInt32();
+		var lo = Avx2.Multiply(a.AsUInt32(), bLo);
+		var cross = Avx2.Multiply((a >> 32).AsUInt32(), bLo) + Avx2.Multiply(a.AsUInt32(), bHi);
+		return lo + (cross << 32);
+	}
+}
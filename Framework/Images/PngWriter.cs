@@ -0,0 +1,373 @@
+using System.Buffers;
+using System.Buffers.Binary;
+using System.IO.Compression;
+using System.Numerics;
+using System.Runtime.InteropServices;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// Writes 8-bit RGBA PNGs.
+/// Large images are split into row blocks that are filtered and deflated in parallel. Each block
+/// ends on a sync flush so the compressed blocks concatenate into a single valid zlib stream.
+/// Holds no mutable shared state, so any number of images can be written from any threads at once.
+/// </summary>
+internal static class PngWriter
+{
+	/// <summary>
+	/// Approximate size of the filtered data in each compressed block
+	/// </summary>
+	private const int BlockSize = 256 * 1024;
+
+	private const int FilterNone = 0;
+	private const int FilterSub = 1;
+	private const int FilterUp = 2;
+	private const int FilterAverage = 3;
+	private const int FilterPaeth = 4;
+
+	private static ReadOnlySpan<byte> Signature => [0x89, (byte)'P', (byte)'N', (byte)'G', 0x0D, 0x0A, 0x1A, 0x0A];
+
+	private static readonly uint[] crcTable = CreateCrcTable();
+
+	/// <summary>
+	/// A compressed block, along with what's needed to stitch it into the final stream
+	/// </summary>
+	private struct Block
+	{
+		public byte[] Data;
+		public int Length;
+		public uint Crc;
+		public uint Adler;
+		public int RawLength;
+	}
+
+	public static void Write(Stream stream, ReadOnlySpan<Color> pixels, int width, int height, PngCompression compression)
+	{
+		if (width <= 0 || height <= 0)
+			throw new Exception("Image must have a size larger than 0");
+		if (pixels.Length < width * height)
+			throw new Exception("Pixel data is smaller than the Image");
+
+		var level = compression switch
+		{
+			PngCompression.Fast => CompressionLevel.Fastest,
+			PngCompression.Balanced => CompressionLevel.Optimal,
+			_ => CompressionLevel.SmallestSize,
+		};
+
+		var rowLength = 1 + width * 4;
+		var rowsPerBlock = Math.Max(1, BlockSize / rowLength);
+		var blockCount = (height + rowsPerBlock - 1) / rowsPerBlock;
+		var blocks = new Block[blockCount];
+
+		// pixels are only read, so they can be shared with the workers through a pointer
+		unsafe
+		{
+			fixed (Color* ptr = pixels)
+			{
+				var source = (nint)ptr;
+				void Compress(int i)
+				{
+					var src = new ReadOnlySpan<Color>((void*)source, width * height);
+					var from = i * rowsPerBlock;
+					var to = Math.Min(height, from + rowsPerBlock);
+					blocks[i] = CompressBlock(src, width, from, to, i == 0, i == blockCount - 1, compression, level);
+				}
+
+				if (blockCount > 1)
+					Parallel.For(0, blockCount, Compress);
+				else
+					Compress(0);
+			}
+		}
+
+		// combine the block checksums into the checksum of the whole stream
+		var adler = blocks[0].Adler;
+		for (int i = 1; i < blockCount; i++)
+			adler = CombineAdler(adler, blocks[i].Adler, blocks[i].RawLength);
+
+		Span<byte> header = stackalloc byte[13];
+		BinaryPrimitives.WriteInt32BigEndian(header[0..], width);
+		BinaryPrimitives.WriteInt32BigEndian(header[4..], height);
+		header[8] = 8;  // bit depth
+		header[9] = 6;  // color type RGBA
+		header[10] = 0; // compression
+		header[11] = 0; // filter
+		header[12] = 0; // interlace
+
+		Span<byte> trailer = stackalloc byte[4];
+		BinaryPrimitives.WriteUInt32BigEndian(trailer, adler);
+
+		stream.Write(Signature);
+		WriteChunk(stream, "IHDR"u8, header);
+
+		// each block becomes its own IDAT chunk, which PNG readers concatenate back together
+		for (int i = 0; i < blockCount; i++)
+		{
+			WriteChunk(stream, "IDAT"u8, blocks[i].Data.AsSpan(0, blocks[i].Length), blocks[i].Crc);
+			ArrayPool<byte>.Shared.Return(blocks[i].Data);
+		}
+
+		WriteChunk(stream, "IDAT"u8, trailer);
+		WriteChunk(stream, "IEND"u8, []);
+	}
+
+	private static Block CompressBlock(ReadOnlySpan<Color> pixels, int width, int from, int to, bool first, bool last, PngCompression compression, CompressionLevel level)
+	{
+		var rowLength = 1 + width * 4;
+		var rawLength = rowLength * (to - from);
+		var raw = ArrayPool<byte>.Shared.Rent(rawLength);
+
+		// filter rows
+		for (int y = from; y < to; y++)
+		{
+			var current = MemoryMarshal.AsBytes(pixels.Slice(y * width, width));
+			var previous = y > 0 ? MemoryMarshal.AsBytes(pixels.Slice((y - 1) * width, width)) : [];
+			var row = raw.AsSpan((y - from) * rowLength, rowLength);
+
+			if (compression == PngCompression.Fast)
+				FilterRowUp(current, previous, row);
+			else
+				FilterRowAdaptive(current, previous, row);
+		}
+
+		// deflate, prefixing the zlib header to the first block
+		using var output = new MemoryStream(rawLength / 2 + 64);
+		if (first)
+		{
+			output.WriteByte(0x78);
+			output.WriteByte(compression switch
+			{
+				PngCompression.Fast => 0x01,
+				PngCompression.Balanced => 0x9C,
+				_ => 0xDA,
+			});
+		}
+
+		int length;
+		var deflate = new DeflateStream(output, level, leaveOpen: true);
+		deflate.Write(raw, 0, rawLength);
+		if (last)
+		{
+			// finishes the stream with a final block
+			deflate.Dispose();
+			length = (int)output.Length;
+		}
+		else
+		{
+			// a sync flush ends on a byte boundary without marking the stream as finished,
+			// and anything written while disposing after that is discarded
+			deflate.Flush();
+			length = (int)output.Length;
+			deflate.Dispose();
+		}
+
+		var block = new Block
+		{
+			Data = ArrayPool<byte>.Shared.Rent(length),
+			Length = length,
+			Adler = Adler32(raw.AsSpan(0, rawLength)),
+			RawLength = rawLength,
+		};
+
+		output.GetBuffer().AsSpan(0, length).CopyTo(block.Data);
+		block.Crc = UpdateCrc(UpdateCrc(0xFFFFFFFF, "IDAT"u8), block.Data.AsSpan(0, length)) ^ 0xFFFFFFFF;
+
+		ArrayPool<byte>.Shared.Return(raw);
+		return block;
+	}
+
+	private static void FilterRowUp(ReadOnlySpan<byte> current, ReadOnlySpan<byte> previous, Span<byte> row)
+	{
+		row[0] = FilterUp;
+		var dst = row[1..];
+
+		if (previous.IsEmpty)
+		{
+			current.CopyTo(dst);
+			return;
+		}
+
+		// byte subtraction wraps, which is exactly what the filter wants
+		var i = 0;
+		if (Vector.IsHardwareAccelerated)
+		{
+			for (; i + Vector<byte>.Count <= current.Length; i += Vector<byte>.Count)
+				(new Vector<byte>(current[i..]) - new Vector<byte>(previous[i..])).CopyTo(dst[i..]);
+		}
+
+		for (; i < current.Length; i++)
+			dst[i] = (byte)(current[i] - previous[i]);
+	}
+
+	private static void FilterRowAdaptive(ReadOnlySpan<byte> current, ReadOnlySpan<byte> previous, Span<byte> row)
+	{
+		// try every filter and keep the one with the smallest sum of absolute (signed) values,
+		// which is the heuristic suggested by the PNG specification
+		byte[]? rented = null;
+		Span<byte> candidate = current.Length <= 4096
+			? stackalloc byte[current.Length]
+			: (rented = ArrayPool<byte>.Shared.Rent(current.Length)).AsSpan(0, current.Length);
+		var dst = row[1..];
+		var best = int.MaxValue;
+
+		for (int filter = FilterNone; filter <= FilterPaeth; filter++)
+		{
+			// without a previous row, Up is the same as None and Paeth is the same as Sub
+			if (previous.IsEmpty && (filter == FilterUp || filter == FilterPaeth))
+				continue;
+
+			FilterRow(filter, current, previous, candidate);
+
+			var sum = 0;
+			for (int i = 0; i < candidate.Length && sum < best; i++)
+				sum += Math.Abs((int)(sbyte)candidate[i]);
+
+			if (sum < best)
+			{
+				best = sum;
+				row[0] = (byte)filter;
+				candidate.CopyTo(dst);
+			}
+		}
+
+		if (rented != null)
+			ArrayPool<byte>.Shared.Return(rented);
+	}
+
+	private static void FilterRow(int filter, ReadOnlySpan<byte> current, ReadOnlySpan<byte> previous, Span<byte> dst)
+	{
+		// the first pixel has no left neighbour
+		var first = Math.Min(4, current.Length);
+
+		switch (filter)
+		{
+			case FilterSub:
+				current[..first].CopyTo(dst);
+				for (int i = first; i < current.Length; i++)
+					dst[i] = (byte)(current[i] - current[i - 4]);
+				break;
+
+			case FilterUp:
+				for (int i = 0; i < current.Length; i++)
+					dst[i] = (byte)(current[i] - previous[i]);
+				break;
+
+			case FilterAverage:
+				if (previous.IsEmpty)
+				{
+					current[..first].CopyTo(dst);
+					for (int i = first; i < current.Length; i++)
+						dst[i] = (byte)(current[i] - (current[i - 4] >> 1));
+				}
+				else
+				{
+					for (int i = 0; i < first; i++)
+						dst[i] = (byte)(current[i] - (previous[i] >> 1));
+					for (int i = first; i < current.Length; i++)
+						dst[i] = (byte)(current[i] - ((current[i - 4] + previous[i]) >> 1));
+				}
+				break;
+
+			case FilterPaeth:
+				for (int i = 0; i < first; i++)
+					dst[i] = (byte)(current[i] - previous[i]);
+				for (int i = first; i < current.Length; i++)
+					dst[i] = (byte)(current[i] - Paeth(current[i - 4], previous[i], previous[i - 4]));
+				break;
+
+			default:
+				current.CopyTo(dst);
+				break;
+		}
+	}
+
+	private static int Paeth(int a, int b, int c)
+	{
+		var p = a + b - c;
+		var pa = Math.Abs(p - a);
+		var pb = Math.Abs(p - b);
+		var pc = Math.Abs(p - c);
+		if (pa <= pb && pa <= pc)
+			return a;
+		if (pb <= pc)
+			return b;
+		return c;
+	}
+
+	private static void WriteChunk(Stream stream, ReadOnlySpan<byte> type, ReadOnlySpan<byte> data)
+	{
+		var crc = UpdateCrc(UpdateCrc(0xFFFFFFFF, type), data) ^ 0xFFFFFFFF;
+		WriteChunk(stream, type, data, crc);
+	}
+
+	private static void WriteChunk(Stream stream, ReadOnlySpan<byte> type, ReadOnlySpan<byte> data, uint crc)
+	{
+		Span<byte> value = stackalloc byte[4];
+		BinaryPrimitives.WriteInt32BigEndian(value, data.Length);
+		stream.Write(value);
+		stream.Write(type);
+		stream.Write(data);
+		BinaryPrimitives.WriteUInt32BigEndian(value, crc);
+		stream.Write(value);
+	}
+
+	private static uint[] CreateCrcTable()
+	{
+		var table = new uint[256];
+		for (uint n = 0; n < 256; n++)
+		{
+			var c = n;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) != 0 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+			table[n] = c;
+		}
+		return table;
+	}
+
+	private static uint UpdateCrc(uint crc, ReadOnlySpan<byte> data)
+	{
+		var table = crcTable;
+		for (int i = 0; i < data.Length; i++)
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return crc;
+	}
+
+	private const uint AdlerBase = 65521;
+
+	private static uint Adler32(ReadOnlySpan<byte> data)
+	{
+		uint a = 1, b = 0;
+		while (data.Length > 0)
+		{
+			// the largest run that can be summed before the values could overflow
+			var count = Math.Min(data.Length, 5552);
+			for (int i = 0; i < count; i++)
+			{
+				a += data[i];
+				b += a;
+			}
+			a %= AdlerBase;
+			b %= AdlerBase;
+			data = data[count..];
+		}
+		return (b << 16) | a;
+	}
+
+	/// <summary>
+	/// Combines the checksum of two sequential runs of data, as zlib's adler32_combine
+	/// </summary>
+	private static uint CombineAdler(uint adler1, uint adler2, int length2)
+	{
+		var remainder = (uint)(length2 % AdlerBase);
+		var sum1 = adler1 & 0xFFFF;
+		var sum2 = (uint)((ulong)remainder * sum1 % AdlerBase);
+		sum1 += (adler2 & 0xFFFF) + AdlerBase - 1;
+		sum2 += ((adler1 >> 16) & 0xFFFF) + ((adler2 >> 16) & 0xFFFF) + AdlerBase - remainder;
+		if (sum1 >= AdlerBase) sum1 -= AdlerBase;
+		if (sum1 >= AdlerBase) sum1 -= AdlerBase;
+		if (sum2 >= AdlerBase << 1) sum2 -= AdlerBase << 1;
+		if (sum2 >= AdlerBase) sum2 -= AdlerBase;
+		return (sum2 << 16) | sum1;
+	}
+}
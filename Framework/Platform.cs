@@ -42,6 +42,14 @@ internal static partial class Platform
 		public FosterFlags flags;
 	}
 
+	[StructLayout(LayoutKind.Sequential)]
+	public struct FosterKerningPair
+	{
+		public int First;
+		public int Second;
+		public float Advance;
+	}
+
 	[StructLayout(LayoutKind.Explicit)]
 	public struct FosterEvent
 	{
@@ -247,8 +255,16 @@ internal static partial class Platform
 	[LibraryImport(DLL)]
 	public static partial void FosterImageFree(nint data);
 	[LibraryImport(DLL)]
+	public static unsafe partial byte FosterImageGetInfo(void* memory, int length, out int w, out int h);
+	[LibraryImport(DLL)]
+	public static unsafe partial byte FosterImageLoadInto(void* memory, int length, void* dest, int destLength, out int w, out int h);
+	[LibraryImport(DLL)]
 	public static unsafe partial byte FosterImageWrite(delegate* unmanaged<nint, nint, int, void> func, IntPtr context, ImageWriteFormat format, int w, int h, IntPtr data);
 	[LibraryImport(DLL)]
+	public static unsafe partial byte FosterImageReadQOIHeader(delegate* unmanaged<nint, nint, int, int> func, IntPtr context, out int w, out int h);
+	[LibraryImport(DLL)]
+	public static unsafe partial byte FosterImageReadQOIPixels(delegate* unmanaged<nint, nint, int, int> func, IntPtr context, void* dest, int w, int h);
+	[LibraryImport(DLL)]
 	public static partial nint FosterFontInit(nint data, int length);
 	[LibraryImport(DLL)]
 	public static partial void FosterFontGetMetrics(nint font, out int ascent, out int descent, out int linegap);
@@ -259,10 +275,18 @@ internal static partial class Platform
 	[LibraryImport(DLL)]
 	public static partial float FosterFontGetKerning(nint font, int glyph1, int glyph2, float scale);
 	[LibraryImport(DLL)]
+	public static unsafe partial FosterKerningPair* FosterFontGetKerningPairs(nint font, int* glyphs, int glyphCount, float scale, out int count);
+	[LibraryImport(DLL)]
+	public static unsafe partial void FosterFontFreeKerningPairs(FosterKerningPair* pairs);
+	[LibraryImport(DLL)]
 	public static partial void FosterFontGetCharacter(nint font, int glyph, float scale, out int width, out int height, out float advance, out float offsetX, out float offsetY, out int visible);
 	[LibraryImport(DLL)]
 	public static partial void FosterFontGetPixels(nint font, nint dest, int glyph, int width, int height, float scale);
 	[LibraryImport(DLL)]
+	public static partial void FosterFontGetSDF(nint font, nint dest, int glyph, int width, int height, float scale, int padding);
+	[LibraryImport(DLL)]
+	public static unsafe partial void FosterFontGetPixelsBatch(nint font, nint dest, int* glyphs, int* widths, int* heights, int count, float scale, int padding);
+	[LibraryImport(DLL)]
 	public static partial void FosterFontFree(nint font);
 	[LibraryImport(DLL)]
 	public static partial Renderers FosterGetRenderer();
@@ -271,8 +295,14 @@ internal static partial class Platform
 	[LibraryImport(DLL)]
 	public static unsafe partial void FosterTextureSetData(nint texture, void* data, int length);
 	[LibraryImport(DLL)]
+	public static unsafe partial void FosterTextureSetSubData(nint texture, int x, int y, int width, int height, void* data, int length);
+	[LibraryImport(DLL)]
+	public static unsafe partial void FosterTextureSetMipData(nint texture, int level, void* data, int length);
+	[LibraryImport(DLL)]
 	public static unsafe partial void FosterTextureGetData(nint texture, void* data, int length);
 	[LibraryImport(DLL)]
+	public static partial void FosterTextureSetCoverage(nint texture);
+	[LibraryImport(DLL)]
 	public static partial void FosterTextureDestroy(nint texture);
 	[LibraryImport(DLL)]
 	public static partial nint FosterTargetCreate(int width, int height, TextureFormat[] formats, int formatCount);
@@ -280,6 +310,16 @@ internal static partial class Platform
 	public static partial nint FosterTargetGetAttachment(nint target, int index);
 	[LibraryImport(DLL)]
 	public static partial void FosterTargetDestroy(nint target);
+	[LibraryImport(DLL)]
+	public static partial nint FosterReadbackCreate(int width, int height);
+	[LibraryImport(DLL)]
+	public static partial void FosterReadbackRequest(nint readback, nint target, int x, int y);
+	[LibraryImport(DLL)]
+	public static partial byte FosterReadbackReady(nint readback);
+	[LibraryImport(DLL)]
+	public static unsafe partial byte FosterReadbackGetData(nint readback, void* data, int length);
+	[LibraryImport(DLL)]
+	public static partial void FosterReadbackDestroy(nint readback);
 	[DllImport(DLL)]
 	public static extern nint FosterShaderCreate(ref FosterShaderData data);
 	[LibraryImport(DLL)]
@@ -0,0 +1,55 @@
+using System.IO.MemoryMappedFiles;
+
+namespace Foster.Framework;
+
+/// <summary>
+/// A read-only view of a whole file, mapped into memory.
+/// This lets file contents be passed to native code without copying them onto the managed heap.
+/// </summary>
+internal sealed unsafe class MappedFile : IDisposable
+{
+	private readonly MemoryMappedFile? file;
+	private readonly MemoryMappedViewAccessor? view;
+	private byte* pointer;
+	private readonly int length;
+
+	/// <summary>
+	/// The contents of the file. Only valid until the MappedFile is disposed.
+	/// </summary>
+	public ReadOnlySpan<byte> Data => pointer == null ? [] : new(pointer, length);
+
+	public MappedFile(string path)
+	{
+		var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read);
+		if (stream.Length > int.MaxValue)
+		{
+			stream.Dispose();
+			throw new Exception($"File '{path}' is too large to map");
+		}
+
+		// empty files can't be mapped
+		length = (int)stream.Length;
+		if (length <= 0)
+		{
+			stream.Dispose();
+			return;
+		}
+
+		file = MemoryMappedFile.CreateFromFile(stream, null, 0, MemoryMappedFileAccess.Read, HandleInheritability.None, false);
+		view = file.CreateViewAccessor(0, length, MemoryMappedFileAccess.Read);
+		view.SafeMemoryMappedViewHandle.AcquirePointer(ref pointer);
+		pointer += view.PointerOffset;
+	}
+
+	public void Dispose()
+	{
+		if (pointer != null)
+		{
+			view!.SafeMemoryMappedViewHandle.ReleasePointer();
+			pointer = null;
+		}
+
+		view?.Dispose();
+		file?.Dispose();
+	}
+}
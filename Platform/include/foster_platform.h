@@ -346,7 +346,8 @@ typedef enum FosterBlendMask
 typedef enum FosterTextureFilter
 {
 	FOSTER_TEXTURE_FILTER_NEAREST,
-	FOSTER_TEXTURE_FILTER_LINEAR
+	FOSTER_TEXTURE_FILTER_LINEAR,
+	FOSTER_TEXTURE_FILTER_TRILINEAR
 } FosterTextureFilter;
 
 typedef enum FosterTextureWrap
@@ -444,9 +445,11 @@ typedef enum FosterEventType
 
 typedef void (FOSTER_CALL * FosterLogFn)(const char *msg, FosterLogLevel level);
 typedef void (FOSTER_CALL * FosterWriteFn)(void *context, void *data, int size);
+typedef int (FOSTER_CALL * FosterReadFn)(void *context, void *data, int size);
 
 typedef struct FosterTexture FosterTexture; 
 typedef struct FosterTarget FosterTarget; 
+typedef struct FosterReadback FosterReadback;
 typedef struct FosterShader FosterShader; 
 typedef struct FosterMesh FosterMesh; 
 
@@ -513,6 +516,13 @@ typedef struct FosterColor
 	unsigned char r, g, b, a;
 } FosterColor;
 
+typedef struct FosterKerningPair
+{
+	int first;
+	int second;
+	float advance;
+} FosterKerningPair;
+
 typedef struct FosterShaderData
 {
 	void* vertexShader;
@@ -632,10 +642,18 @@ FOSTER_API FosterBool FosterGetFocused();
 
 FOSTER_API unsigned char* FosterImageLoad(const unsigned char* memory, int length, int* w, int* h);
 
+FOSTER_API FosterBool FosterImageGetInfo(const unsigned char* memory, int length, int* w, int* h);
+
+FOSTER_API FosterBool FosterImageLoadInto(const unsigned char* memory, int length, unsigned char* dest, int destLength, int* w, int* h);
+
 FOSTER_API void FosterImageFree(unsigned char* data);
 
 FOSTER_API FosterBool FosterImageWrite(FosterWriteFn* func, void* context, FosterImageWriteFormat format, int w, int h, const void* data);
 
+FOSTER_API FosterBool FosterImageReadQOIHeader(FosterReadFn func, void* context, int* w, int* h);
+
+FOSTER_API FosterBool FosterImageReadQOIPixels(FosterReadFn func, void* context, unsigned char* dest, int w, int h);
+
 FOSTER_API FosterFont* FosterFontInit(unsigned char* data, int length);
 
 FOSTER_API void FosterFontGetMetrics(FosterFont* font, int* ascent, int* descent, int* linegap);
@@ -648,8 +666,16 @@ FOSTER_API float FosterFontGetKerning(FosterFont* font, int glyph1, int glyph2,
 
 FOSTER_API void FosterFontGetCharacter(FosterFont* font, int glyph, float scale, int* width, int* height, float* advance, float* offsetX, float* offsetY, int* visible);
 
+FOSTER_API FosterKerningPair* FosterFontGetKerningPairs(FosterFont* font, const int* glyphs, int glyphCount, float scale, int* count);
+
+FOSTER_API void FosterFontFreeKerningPairs(FosterKerningPair* pairs);
+
 FOSTER_API void FosterFontGetPixels(FosterFont* font, unsigned char* dest, int glyph, int width, int height, float scale);
 
+FOSTER_API void FosterFontGetSDF(FosterFont* font, unsigned char* dest, int glyph, int width, int height, float scale, int padding);
+
+FOSTER_API void FosterFontGetPixelsBatch(FosterFont* font, unsigned char* dest, const int* glyphs, const int* widths, const int* heights, int count, float scale, int padding);
+
 FOSTER_API void FosterFontFree(FosterFont* font);
 
 FOSTER_API FosterRenderers FosterGetRenderer();
@@ -658,8 +684,14 @@ FOSTER_API FosterTexture* FosterTextureCreate(int width, int height, FosterTextu
 
 FOSTER_API void FosterTextureSetData(FosterTexture* texture, void* data, int length);
 
+FOSTER_API void FosterTextureSetSubData(FosterTexture* texture, int x, int y, int width, int height, void* data, int length);
+
+FOSTER_API void FosterTextureSetMipData(FosterTexture* texture, int level, void* data, int length);
+
 FOSTER_API void FosterTextureGetData(FosterTexture* texture, void* data, int length);
 
+FOSTER_API void FosterTextureSetCoverage(FosterTexture* texture);
+
 FOSTER_API void FosterTextureDestroy(FosterTexture* texture);
 
 FOSTER_API FosterTarget* FosterTargetCreate(int width, int height, FosterTextureFormat* attachments, int attachmentCount);
@@ -668,6 +700,16 @@ FOSTER_API FosterTexture* FosterTargetGetAttachment(FosterTarget* target, int in
 
 FOSTER_API void FosterTargetDestroy(FosterTarget* target);
 
+FOSTER_API FosterReadback* FosterReadbackCreate(int width, int height);
+
+FOSTER_API void FosterReadbackRequest(FosterReadback* readback, FosterTarget* target, int x, int y);
+
+FOSTER_API FosterBool FosterReadbackReady(FosterReadback* readback);
+
+FOSTER_API FosterBool FosterReadbackGetData(FosterReadback* readback, void* data, int length);
+
+FOSTER_API void FosterReadbackDestroy(FosterReadback* readback);
+
 FOSTER_API FosterShader* FosterShaderCreate(FosterShaderData* data);
 
 FOSTER_API void FosterShaderGetUniforms(FosterShader* shader, FosterUniformInfo* output, int* count, int max);
@@ -14,6 +14,13 @@
 #define QOI_FREE(p) STBI_FREE(p) 
 #include "third_party/qoi.h"
 
+// QOI images are streamed through the read/write callbacks in chunks of this size,
+// so encoding and decoding never hold more than this much of the encoded data
+#define FOSTER_QOI_CHUNK_SIZE 16384
+
+// the largest QOI operation is QOI_OP_RGBA, at 5 bytes
+#define FOSTER_QOI_MAX_OP 5
+
 bool FosterImage_TestQOI(const unsigned char* data, int length);
 unsigned char* FosterImage_LoadQOI(const unsigned char* data, int length, int* w, int * h);
 bool FosterImage_WriteQOI(FosterWriteFn* func, void* context, int w, int h, const void* data);
@@ -33,6 +40,42 @@ unsigned char* FosterImageLoad(const unsigned char* data, int length, int* w, in
 	}
 }
 
+FosterBool FosterImageGetInfo(const unsigned char* data, int length, int* w, int* h)
+{
+	if (FosterImage_TestQOI(data, length))
+	{
+		int p = 4;
+		*w = (int)qoi_read_32(data, &p);
+		*h = (int)qoi_read_32(data, &p);
+		return *w > 0 && *h > 0;
+	}
+	else
+	{
+		int c;
+		return stbi_info_from_memory(data, length, w, h, &c) != 0;
+	}
+}
+
+FosterBool FosterImageLoadInto(const unsigned char* data, int length, unsigned char* dest, int destLength, int* w, int* h)
+{
+	// the decoders always allocate their own output, so this decodes and copies it once into the
+	// destination, which lets callers reuse their own buffers instead of holding the decoder's
+	unsigned char* pixels = FosterImageLoad(data, length, w, h);
+	if (pixels == NULL)
+		return false;
+
+	int size = (*w) * (*h) * 4;
+	if (size > destLength)
+	{
+		stbi_image_free(pixels);
+		return false;
+	}
+
+	SDL_memcpy(dest, pixels, size);
+	stbi_image_free(pixels);
+	return true;
+}
+
 void FosterImageFree(unsigned char* data)
 {
 	stbi_image_free(data);
@@ -85,16 +128,264 @@ unsigned char* FosterImage_LoadQOI(const unsigned char* data, int length, int* w
 
 bool FosterImage_WriteQOI(FosterWriteFn* func, void* context, int w, int h, const void* data)
 {
-	qoi_desc desc = { w, h, 4, 1 };
-	int length;
-	void* encoded = qoi_encode(data, &desc, &length);
+	unsigned char bytes[FOSTER_QOI_CHUNK_SIZE];
+	const unsigned char* pixels = (const unsigned char*)data;
+	qoi_rgba_t index[64];
+	qoi_rgba_t px, px_prev;
+	int p = 0, run = 0;
+	int px_len, px_end, px_pos;
+
+	if (data == NULL || w <= 0 || h <= 0 || (unsigned int)h >= QOI_PIXELS_MAX / (unsigned int)w)
+		return false;
+
+	qoi_write_32(bytes, &p, QOI_MAGIC);
+	qoi_write_32(bytes, &p, w);
+	qoi_write_32(bytes, &p, h);
+	bytes[p++] = 4;
+	bytes[p++] = QOI_LINEAR;
 
-	if (encoded != NULL)
+	QOI_ZEROARR(index);
+	px_prev.rgba.r = 0;
+	px_prev.rgba.g = 0;
+	px_prev.rgba.b = 0;
+	px_prev.rgba.a = 255;
+
+	px_len = w * h * 4;
+	px_end = px_len - 4;
+
+	// same encoding as qoi_encode, except the output is flushed through the
+	// callback whenever the chunk can't fit another operation
+	for (px_pos = 0; px_pos < px_len; px_pos += 4)
 	{
-		((stbi_write_func*)func)(context, encoded, length);
-		QOI_FREE(encoded);
-		return true;
+		if (p > FOSTER_QOI_CHUNK_SIZE - FOSTER_QOI_MAX_OP * 2)
+		{
+			((stbi_write_func*)func)(context, bytes, p);
+			p = 0;
+		}
+
+		px.rgba.r = pixels[px_pos + 0];
+		px.rgba.g = pixels[px_pos + 1];
+		px.rgba.b = pixels[px_pos + 2];
+		px.rgba.a = pixels[px_pos + 3];
+
+		if (px.v == px_prev.v)
+		{
+			run++;
+			if (run == 62 || px_pos == px_end)
+			{
+				bytes[p++] = QOI_OP_RUN | (run - 1);
+				run = 0;
+			}
+		}
+		else
+		{
+			int index_pos;
+
+			if (run > 0)
+			{
+				bytes[p++] = QOI_OP_RUN | (run - 1);
+				run = 0;
+			}
+
+			index_pos = QOI_COLOR_HASH(px) % 64;
+
+			if (index[index_pos].v == px.v)
+			{
+				bytes[p++] = QOI_OP_INDEX | index_pos;
+			}
+			else
+			{
+				index[index_pos] = px;
+
+				if (px.rgba.a == px_prev.rgba.a)
+				{
+					signed char vr = px.rgba.r - px_prev.rgba.r;
+					signed char vg = px.rgba.g - px_prev.rgba.g;
+					signed char vb = px.rgba.b - px_prev.rgba.b;
+					signed char vg_r = vr - vg;
+					signed char vg_b = vb - vg;
+
+					if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+					{
+						bytes[p++] = QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2);
+					}
+					else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8)
+					{
+						bytes[p++] = QOI_OP_LUMA | (vg + 32);
+						bytes[p++] = (vg_r + 8) << 4 | (vg_b + 8);
+					}
+					else
+					{
+						bytes[p++] = QOI_OP_RGB;
+						bytes[p++] = px.rgba.r;
+						bytes[p++] = px.rgba.g;
+						bytes[p++] = px.rgba.b;
+					}
+				}
+				else
+				{
+					bytes[p++] = QOI_OP_RGBA;
+					bytes[p++] = px.rgba.r;
+					bytes[p++] = px.rgba.g;
+					bytes[p++] = px.rgba.b;
+					bytes[p++] = px.rgba.a;
+				}
+			}
+		}
+
+		px_prev = px;
 	}
 
-	return false;
+	if (p > FOSTER_QOI_CHUNK_SIZE - (int)sizeof(qoi_padding))
+	{
+		((stbi_write_func*)func)(context, bytes, p);
+		p = 0;
+	}
+
+	SDL_memcpy(bytes + p, qoi_padding, sizeof(qoi_padding));
+	p += sizeof(qoi_padding);
+	((stbi_write_func*)func)(context, bytes, p);
+	return true;
+}
+
+// reads until the buffer is full or the callback has no more data
+static int FosterImage_ReadAll(FosterReadFn func, void* context, unsigned char* data, int size)
+{
+	int total = 0;
+	while (total < size)
+	{
+		int read = func(context, data + total, size - total);
+		if (read <= 0)
+			break;
+		total += read;
+	}
+	return total;
+}
+
+FosterBool FosterImageReadQOIHeader(FosterReadFn func, void* context, int* w, int* h)
+{
+	unsigned char bytes[QOI_HEADER_SIZE];
+	int p = 0;
+	unsigned int magic, channels, colorspace;
+
+	*w = *h = 0;
+
+	if (FosterImage_ReadAll(func, context, bytes, QOI_HEADER_SIZE) != QOI_HEADER_SIZE)
+		return false;
+
+	magic = qoi_read_32(bytes, &p);
+	*w = (int)qoi_read_32(bytes, &p);
+	*h = (int)qoi_read_32(bytes, &p);
+	channels = bytes[p++];
+	colorspace = bytes[p++];
+
+	if (magic != QOI_MAGIC || *w <= 0 || *h <= 0 ||
+		channels < 3 || channels > 4 || colorspace > 1 ||
+		(unsigned int)*h >= QOI_PIXELS_MAX / (unsigned int)*w)
+	{
+		*w = *h = 0;
+		return false;
+	}
+
+	return true;
+}
+
+FosterBool FosterImageReadQOIPixels(FosterReadFn func, void* context, unsigned char* dest, int w, int h)
+{
+	unsigned char bytes[FOSTER_QOI_CHUNK_SIZE];
+	qoi_rgba_t index[64];
+	qoi_rgba_t px;
+	int p = 0, length = 0, run = 0, eof = 0;
+	int px_len, px_pos;
+
+	if (dest == NULL || w <= 0 || h <= 0)
+		return false;
+
+	QOI_ZEROARR(index);
+	px.rgba.r = 0;
+	px.rgba.g = 0;
+	px.rgba.b = 0;
+	px.rgba.a = 255;
+
+	px_len = w * h * 4;
+
+	// same decoding as qoi_decode, except the input is refilled through the
+	// callback whenever the chunk may not hold a whole operation
+	for (px_pos = 0; px_pos < px_len; px_pos += 4)
+	{
+		if (run > 0)
+		{
+			run--;
+		}
+		else
+		{
+			if (length - p < FOSTER_QOI_MAX_OP && !eof)
+			{
+				length -= p;
+				SDL_memmove(bytes, bytes + p, length);
+				p = 0;
+
+				int read = FosterImage_ReadAll(func, context, bytes + length, FOSTER_QOI_CHUNK_SIZE - length);
+				if (read < FOSTER_QOI_CHUNK_SIZE - length)
+					eof = 1;
+				length += read;
+			}
+
+			if (p >= length)
+				return false;
+
+			int b1 = bytes[p++];
+
+			if (b1 == QOI_OP_RGB)
+			{
+				if (p + 3 > length)
+					return false;
+				px.rgba.r = bytes[p++];
+				px.rgba.g = bytes[p++];
+				px.rgba.b = bytes[p++];
+			}
+			else if (b1 == QOI_OP_RGBA)
+			{
+				if (p + 4 > length)
+					return false;
+				px.rgba.r = bytes[p++];
+				px.rgba.g = bytes[p++];
+				px.rgba.b = bytes[p++];
+				px.rgba.a = bytes[p++];
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX)
+			{
+				px = index[b1];
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF)
+			{
+				px.rgba.r += ((b1 >> 4) & 0x03) - 2;
+				px.rgba.g += ((b1 >> 2) & 0x03) - 2;
+				px.rgba.b += ( b1       & 0x03) - 2;
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA)
+			{
+				if (p + 1 > length)
+					return false;
+				int b2 = bytes[p++];
+				int vg = (b1 & 0x3f) - 32;
+				px.rgba.r += vg - 8 + ((b2 >> 4) & 0x0f);
+				px.rgba.g += vg;
+				px.rgba.b += vg - 8 +  (b2       & 0x0f);
+			}
+			else if ((b1 & QOI_MASK_2) == QOI_OP_RUN)
+			{
+				run = (b1 & 0x3f);
+			}
+
+			index[QOI_COLOR_HASH(px) % 64] = px;
+		}
+
+		dest[px_pos + 0] = px.rgba.r;
+		dest[px_pos + 1] = px.rgba.g;
+		dest[px_pos + 2] = px.rgba.b;
+		dest[px_pos + 3] = px.rgba.a;
+	}
+
+	return true;
 }
@@ -533,6 +533,256 @@ float FosterFontGetKerning(FosterFont* font, int glyph1, int glyph2, float scale
 	return stbtt_GetGlyphKernAdvance(info, glyph1, glyph2) * scale;
 }
 
+typedef struct FosterKerningBuffer
+{
+	FosterKerningPair* pairs;
+	int count;
+	int capacity;
+} FosterKerningBuffer;
+
+static void FosterKerningPush(FosterKerningBuffer* buffer, int first, int second, float advance)
+{
+	if (buffer->count >= buffer->capacity)
+	{
+		buffer->capacity = buffer->capacity > 0 ? buffer->capacity * 2 : 256;
+		buffer->pairs = (FosterKerningPair*)SDL_realloc(buffer->pairs, sizeof(FosterKerningPair) * buffer->capacity);
+	}
+
+	FosterKerningPair* pair = &buffer->pairs[buffer->count++];
+	pair->first = first;
+	pair->second = second;
+	pair->advance = advance;
+}
+
+typedef struct FosterPairPosTable
+{
+	stbtt_uint8* table;
+	int* classStarts;
+	int* classMembers;
+} FosterPairPosTable;
+
+// Reads kerning from the GPOS Pair Adjustment subtables directly, rather than searching them per pair.
+// This follows stbtt_GetGlyphKernAdvance: subtables are searched in order, and a Format 1 subtable that
+// doesn't list a pair falls through to the later ones, while a Format 2 subtable decides every remaining
+// pair of a glyph it covers. Only subtables with a plain X Advance on the first glyph are used.
+static void FosterFontGetGposPairs(stbtt_fontinfo* info, const int* lookup, const int* glyphs, int glyphCount, float scale, FosterKerningBuffer* out)
+{
+	stbtt_uint8* data = info->data + info->gpos;
+	if (ttUSHORT(data + 0) != 1 || ttUSHORT(data + 2) != 0)
+		return;
+
+	stbtt_uint8* lookupList = data + ttUSHORT(data + 8);
+	int lookupCount = ttUSHORT(lookupList);
+
+	// collect the pair subtables in the order they're searched
+	int tableCount = 0;
+	for (int i = 0; i < lookupCount; i ++)
+	{
+		stbtt_uint8* lookupTable = lookupList + ttUSHORT(lookupList + 2 + 2 * i);
+		if (ttUSHORT(lookupTable) == 2)
+			tableCount += ttUSHORT(lookupTable + 4);
+	}
+	if (tableCount <= 0)
+		return;
+
+	FosterPairPosTable* tables = (FosterPairPosTable*)SDL_calloc(tableCount, sizeof(FosterPairPosTable));
+	for (int i = 0, t = 0; i < lookupCount; i ++)
+	{
+		stbtt_uint8* lookupTable = lookupList + ttUSHORT(lookupList + 2 + 2 * i);
+		if (ttUSHORT(lookupTable) != 2)
+			continue;
+
+		int subTableCount = ttUSHORT(lookupTable + 4);
+		for (int j = 0; j < subTableCount; j ++)
+			tables[t ++].table = lookupTable + ttUSHORT(lookupTable + 6 + 2 * j);
+	}
+
+	// the pairs of the current first glyph that an earlier subtable already decided
+	int* seen = (int*)SDL_calloc(glyphCount > 0 ? glyphCount : 1, sizeof(int));
+
+	for (int a = 0; a < glyphCount; a ++)
+	{
+		// duplicates and invalid glyphs are skipped, same as the 'kern' table path
+		if (glyphs[a] < 0 || glyphs[a] >= info->numGlyphs || lookup[glyphs[a]] != a + 1)
+			continue;
+
+		int stamp = a + 1;
+		for (int t = 0; t < tableCount; t ++)
+		{
+			FosterPairPosTable* it = &tables[t];
+			stbtt_uint8* table = it->table;
+			int coverageIndex = stbtt__GetCoverageIndex(table + ttUSHORT(table + 2), glyphs[a]);
+			if (coverageIndex < 0)
+				continue;
+
+			int posFormat = ttUSHORT(table);
+			if (ttUSHORT(table + 4) != 4 || ttUSHORT(table + 6) != 0)
+				break;
+
+			if (posFormat == 1)
+			{
+				if (coverageIndex >= ttUSHORT(table + 8))
+					break;
+
+				// every second glyph this one kerns with is listed, so only those are visited,
+				// and the rest are left to the following subtables
+				stbtt_uint8* pairSet = table + ttUSHORT(table + 10 + 2 * coverageIndex);
+				int pairCount = ttUSHORT(pairSet);
+				for (int p = 0; p < pairCount; p ++)
+				{
+					stbtt_uint8* pair = pairSet + 2 + 4 * p;
+					int second = ttUSHORT(pair);
+					if (second >= info->numGlyphs || lookup[second] <= 0)
+						continue;
+
+					int b = lookup[second] - 1;
+					if (seen[b] == stamp)
+						continue;
+					seen[b] = stamp;
+
+					int advance = ttSHORT(pair + 2);
+					if (advance != 0)
+						FosterKerningPush(out, a, b, advance * scale);
+				}
+				continue;
+			}
+
+			if (posFormat == 2)
+			{
+				stbtt_uint8* classDef1 = table + ttUSHORT(table + 8);
+				stbtt_uint8* classDef2 = table + ttUSHORT(table + 10);
+				int class1Count = ttUSHORT(table + 12);
+				int class2Count = ttUSHORT(table + 14);
+
+				int class1 = stbtt__GetGlyphClass(classDef1, glyphs[a]);
+				if (class1 < 0 || class1 >= class1Count)
+					break;
+
+				// group the set by second class once per subtable, so each row only visits the classes it kerns
+				if (!it->classStarts)
+				{
+					int* classes = (int*)SDL_malloc(sizeof(int) * (glyphCount > 0 ? glyphCount : 1));
+					it->classStarts = (int*)SDL_calloc(class2Count + 1, sizeof(int));
+					it->classMembers = (int*)SDL_malloc(sizeof(int) * (glyphCount > 0 ? glyphCount : 1));
+
+					for (int b = 0; b < glyphCount; b ++)
+					{
+						classes[b] = -1;
+						if (glyphs[b] < 0 || glyphs[b] >= info->numGlyphs || lookup[glyphs[b]] != b + 1)
+							continue;
+						int c = stbtt__GetGlyphClass(classDef2, glyphs[b]);
+						if (c < 0 || c >= class2Count)
+							continue;
+						classes[b] = c;
+						it->classStarts[c + 1] ++;
+					}
+					for (int c = 0; c < class2Count; c ++)
+						it->classStarts[c + 1] += it->classStarts[c];
+
+					int* cursor = (int*)SDL_malloc(sizeof(int) * (class2Count > 0 ? class2Count : 1));
+					SDL_memcpy(cursor, it->classStarts, sizeof(int) * class2Count);
+					for (int b = 0; b < glyphCount; b ++)
+					{
+						if (classes[b] >= 0)
+							it->classMembers[cursor[classes[b]] ++] = b;
+					}
+
+					SDL_free(cursor);
+					SDL_free(classes);
+				}
+
+				stbtt_uint8* row = table + 16 + 2 * (class1 * class2Count);
+				for (int c = 0; c < class2Count; c ++)
+				{
+					int advance = ttSHORT(row + 2 * c);
+					if (advance == 0)
+						continue;
+					for (int m = it->classStarts[c]; m < it->classStarts[c + 1]; m ++)
+					{
+						int b = it->classMembers[m];
+						if (seen[b] != stamp)
+							FosterKerningPush(out, a, b, advance * scale);
+					}
+				}
+			}
+
+			// any other subtable ends the search for this glyph, as stb returns from it
+			break;
+		}
+	}
+
+	SDL_free(seen);
+
+	for (int t = 0; t < tableCount; t ++)
+	{
+		SDL_free(tables[t].classStarts);
+		SDL_free(tables[t].classMembers);
+	}
+	SDL_free(tables);
+}
+
+FosterKerningPair* FosterFontGetKerningPairs(FosterFont* font, const int* glyphs, int glyphCount, float scale, int* count)
+{
+	stbtt_fontinfo* info = (stbtt_fontinfo*)font;
+	FosterKerningBuffer buffer = { NULL, 0, 0 };
+
+	if (!info->gpos && !info->kern)
+	{
+		*count = 0;
+		return NULL;
+	}
+
+	// map glyphs to their index in the requested set
+	int* lookup = (int*)SDL_calloc(info->numGlyphs > 0 ? info->numGlyphs : 1, sizeof(int));
+	for (int i = glyphCount - 1; i >= 0; i --)
+	{
+		if (glyphs[i] >= 0 && glyphs[i] < info->numGlyphs)
+			lookup[glyphs[i]] = i + 1;
+	}
+
+	// stbtt_GetGlyphKernAdvance only uses the 'kern' table if there is no GPOS table
+	if (info->gpos)
+	{
+		FosterFontGetGposPairs(info, lookup, glyphs, glyphCount, scale, &buffer);
+	}
+	else
+	{
+		int tableLength = stbtt_GetKerningTableLength(info);
+		if (tableLength > 0)
+		{
+			stbtt_kerningentry* table = (stbtt_kerningentry*)SDL_malloc(sizeof(stbtt_kerningentry) * tableLength);
+			tableLength = stbtt_GetKerningTable(info, table, tableLength);
+
+			for (int i = 0; i < tableLength; i ++)
+			{
+				stbtt_kerningentry* entry = &table[i];
+				if (entry->advance == 0 ||
+					entry->glyph1 < 0 || entry->glyph1 >= info->numGlyphs ||
+					entry->glyph2 < 0 || entry->glyph2 >= info->numGlyphs)
+					continue;
+
+				int a = lookup[entry->glyph1];
+				int b = lookup[entry->glyph2];
+				if (a > 0 && b > 0)
+					FosterKerningPush(&buffer, a - 1, b - 1, entry->advance * scale);
+			}
+
+			SDL_free(table);
+		}
+	}
+
+	SDL_free(lookup);
+
+	// the caller frees the pairs with FosterFontFreeKerningPairs
+	*count = buffer.count;
+	return buffer.pairs;
+}
+
+void FosterFontFreeKerningPairs(FosterKerningPair* pairs)
+{
+	SDL_free(pairs);
+}
+
 void FosterFontGetCharacter(FosterFont* font, int glyph, float scale, int* width, int* height, float* advance, float* offsetX, float* offsetY, int* visible)
 {
 	stbtt_fontinfo* info = (stbtt_fontinfo*)font;
@@ -568,6 +818,50 @@ void FosterFontGetPixels(FosterFont* font, unsigned char* dest, int glyph, int w
 	}
 }
 
+void FosterFontGetSDF(FosterFont* font, unsigned char* dest, int glyph, int width, int height, float scale, int padding)
+{
+	stbtt_fontinfo* info = (stbtt_fontinfo*)font;
+
+	// distance is stored so the glyph edge is at 128, and falls off to 0 over the padding
+	const unsigned char onedge = 128;
+	float distanceScale = onedge / (float)(padding > 0 ? padding : 1);
+
+	int w, h, ox, oy;
+	unsigned char* sdf = stbtt_GetGlyphSDF(info, scale, glyph, padding, onedge, distanceScale, &w, &h, &ox, &oy);
+
+	SDL_memset(dest, 0, width * height * 4);
+	if (sdf == NULL)
+		return;
+
+	// copy to the RGBA dest buffer, clipped to the requested size
+	for (int y = 0; y < h && y < height; y ++)
+	for (int x = 0; x < w && x < width; x ++)
+	{
+		unsigned char value = sdf[x + y * w];
+		unsigned char* pixel = dest + (x + y * width) * 4;
+		pixel[0] = value;
+		pixel[1] = value;
+		pixel[2] = value;
+		pixel[3] = value;
+	}
+
+	stbtt_FreeSDF(sdf, info->userdata);
+}
+
+void FosterFontGetPixelsBatch(FosterFont* font, unsigned char* dest, const int* glyphs, const int* widths, const int* heights, int count, float scale, int padding)
+{
+	// each glyph is written to dest one after another, as tightly packed RGBA data
+	for (int i = 0; i < count; i ++)
+	{
+		if (padding > 0)
+			FosterFontGetSDF(font, dest, glyphs[i], widths[i], heights[i], scale, padding);
+		else
+			FosterFontGetPixels(font, dest, glyphs[i], widths[i], heights[i], scale);
+
+		dest += widths[i] * heights[i] * 4;
+	}
+}
+
 void FosterFontFree(FosterFont* font)
 {
 	stbtt_fontinfo* info = (stbtt_fontinfo*)font;
@@ -592,12 +886,30 @@ void FosterTextureSetData(FosterTexture* texture, void* data, int length)
 	fstate.device.textureSetData(texture, data, length);
 }
 
+void FosterTextureSetSubData(FosterTexture* texture, int x, int y, int width, int height, void* data, int length)
+{
+	FOSTER_ASSERT_RUNNING(FosterTextureSetSubData);
+	fstate.device.textureSetSubData(texture, x, y, width, height, data, length);
+}
+
+void FosterTextureSetMipData(FosterTexture* texture, int level, void* data, int length)
+{
+	FOSTER_ASSERT_RUNNING(FosterTextureSetMipData);
+	fstate.device.textureSetMipData(texture, level, data, length);
+}
+
 void FosterTextureGetData(FosterTexture* texture, void* data, int length)
 {
 	FOSTER_ASSERT_RUNNING(FosterTextureGetData);
 	fstate.device.textureGetData(texture, data, length);
 }
 
+void FosterTextureSetCoverage(FosterTexture* texture)
+{
+	FOSTER_ASSERT_RUNNING(FosterTextureSetCoverage);
+	fstate.device.textureSetCoverage(texture);
+}
+
 void FosterTextureDestroy(FosterTexture* texture)
 {
 	FOSTER_ASSERT_RUNNING(FosterTextureDestroy);
@@ -626,6 +938,36 @@ void FosterTargetDestroy(FosterTarget* target)
 	fstate.device.targetDestroy(target);
 }
 
+FosterReadback* FosterReadbackCreate(int width, int height)
+{
+	FOSTER_ASSERT_RUNNING_RET(FosterReadbackCreate, NULL);
+	return fstate.device.readbackCreate(width, height);
+}
+
+void FosterReadbackRequest(FosterReadback* readback, FosterTarget* target, int x, int y)
+{
+	FOSTER_ASSERT_RUNNING(FosterReadbackRequest);
+	fstate.device.readbackRequest(readback, target, x, y);
+}
+
+FosterBool FosterReadbackReady(FosterReadback* readback)
+{
+	FOSTER_ASSERT_RUNNING_RET(FosterReadbackReady, false);
+	return fstate.device.readbackReady(readback);
+}
+
+FosterBool FosterReadbackGetData(FosterReadback* readback, void* data, int length)
+{
+	FOSTER_ASSERT_RUNNING_RET(FosterReadbackGetData, false);
+	return fstate.device.readbackGetData(readback, data, length);
+}
+
+void FosterReadbackDestroy(FosterReadback* readback)
+{
+	FOSTER_ASSERT_RUNNING(FosterReadbackDestroy);
+	fstate.device.readbackDestroy(readback);
+}
+
 FosterShader* FosterShaderCreate(FosterShaderData* data)
 {
 	FOSTER_ASSERT_RUNNING_RET(FosterShaderCreate, NULL);
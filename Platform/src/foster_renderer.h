@@ -16,13 +16,22 @@ typedef struct FosterRenderDevice
 	
 	FosterTexture* (*textureCreate)(int width, int height, FosterTextureFormat format);
 	void (*textureSetData)(FosterTexture* texture, void* data, int length);
+	void (*textureSetSubData)(FosterTexture* texture, int x, int y, int width, int height, void* data, int length);
+	void (*textureSetMipData)(FosterTexture* texture, int level, void* data, int length);
 	void (*textureGetData)(FosterTexture* texture, void* data, int length);
+	void (*textureSetCoverage)(FosterTexture* texture);
 	void (*textureDestroy)(FosterTexture* texture);
 
 	FosterTarget* (*targetCreate)(int width, int height, FosterTextureFormat* formats, int format_count);
 	FosterTexture* (*targetGetAttachment)(FosterTarget* target, int index);
 	void (*targetDestroy)(FosterTarget* target);
 
+	FosterReadback* (*readbackCreate)(int width, int height);
+	void (*readbackRequest)(FosterReadback* readback, FosterTarget* target, int x, int y);
+	bool (*readbackReady)(FosterReadback* readback);
+	bool (*readbackGetData)(FosterReadback* readback, void* data, int length);
+	void (*readbackDestroy)(FosterReadback* readback);
+
 	FosterShader* (*shaderCreate)(FosterShaderData* data);
 	void (*shaderSetUniform)(FosterShader* shader, int index, float* values);
 	void (*shaderSetTexture)(FosterShader* shader, int index, FosterTexture** values);
@@ -32,6 +32,8 @@ typedef float            GLclampf;    /* single precision float in [0,1] */
 typedef double           GLdouble;    /* double precision float */
 typedef double           GLclampd;    /* double precision float in [0,1] */
 typedef char             GLchar;
+typedef unsigned long long GLuint64;
+typedef struct __GLsync* GLsync;
 
 // OpenGL Constants
 #define GL_DONT_CARE 0x1100
@@ -156,6 +158,10 @@ typedef char             GLchar;
 #define GL_DEPTH_STENCIL 0x84F9
 #define GL_TEXTURE_WRAP_S 0x2802
 #define GL_TEXTURE_WRAP_T 0x2803
+#define GL_TEXTURE_SWIZZLE_R 0x8E42
+#define GL_TEXTURE_SWIZZLE_G 0x8E43
+#define GL_TEXTURE_SWIZZLE_B 0x8E44
+#define GL_TEXTURE_SWIZZLE_A 0x8E45
 #define GL_TEXTURE_WRAP_R 0x8072
 #define GL_TEXTURE_MAG_FILTER 0x2800
 #define GL_TEXTURE_MIN_FILTER 0x2801
@@ -171,6 +177,12 @@ typedef char             GLchar;
 #define GL_ARRAY_BUFFER 0x8892
 #define GL_ELEMENT_ARRAY_BUFFER 0x8893
 #define GL_STREAM_DRAW 0x88E0
+#define GL_STREAM_READ 0x88E1
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_MAP_READ_BIT 0x0001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_CONDITION_SATISFIED 0x911C
 #define GL_STATIC_DRAW 0x88E4
 #define GL_DYNAMIC_DRAW 0x88E8
 #define GL_MAX_VERTEX_ATTRIBS 0x8869
@@ -256,6 +268,7 @@ typedef char             GLchar;
 	GL_FUNC(BindRenderbuffer, void, GLenum target, GLuint id) \
 	GL_FUNC(BindFramebuffer, void, GLenum target, GLuint id) \
 	GL_FUNC(TexImage2D, void, GLenum target, GLint level, GLenum internalFormat, GLint width, GLint height, GLint border, GLenum format, GLenum type, const void* data) \
+	GL_FUNC(TexSubImage2D, void, GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint width, GLint height, GLenum format, GLenum type, const void* data) \
 	GL_FUNC(FramebufferRenderbuffer, void, GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) \
 	GL_FUNC(FramebufferTexture2D, void, GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) \
 	GL_FUNC(TexParameteri, void, GLenum target, GLenum name, GLint param) \
@@ -330,7 +343,14 @@ typedef char             GLchar;
 	GL_FUNC(UniformMatrix4x2fv, void, GLint location, GLint count, GLboolean transpose, const GLfloat* value) \
 	GL_FUNC(UniformMatrix3x4fv, void, GLint location, GLint count, GLboolean transpose, const GLfloat* value) \
 	GL_FUNC(UniformMatrix4x3fv, void, GLint location, GLint count, GLboolean transpose, const GLfloat* value) \
-	GL_FUNC(PixelStorei, void, GLenum pname, GLint param)
+	GL_FUNC(PixelStorei, void, GLenum pname, GLint param) \
+	GL_FUNC(ReadBuffer, void, GLenum mode) \
+	GL_FUNC(ReadPixels, void, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* data) \
+	GL_FUNC(MapBufferRange, void*, GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) \
+	GL_FUNC(UnmapBuffer, GLboolean, GLenum target) \
+	GL_FUNC(FenceSync, GLsync, GLenum condition, GLbitfield flags) \
+	GL_FUNC(ClientWaitSync, GLenum, GLsync sync, GLbitfield flags, GLuint64 timeout) \
+	GL_FUNC(DeleteSync, void, GLsync sync)
 
 // Debug Function Delegate
 typedef void (APIENTRY* DEBUGPROC)(GLenum source,
@@ -359,6 +379,7 @@ typedef struct FosterTexture_OpenGL
 	GLenum glType;
 	GLenum glAttachment;
 	FosterTextureSampler sampler;
+	int mipLevels;
 
 	// Because Shader uniforms assign textures, it's possible for the user to
 	// dispose of a texture but still have it assigned in a shader. Thus we use
@@ -414,6 +435,14 @@ typedef struct FosterMesh_OpenGL
 	int indexBufferSize;
 } FosterMesh_OpenGL;
 
+typedef struct FosterReadback_OpenGL
+{
+	GLuint buffer;
+	GLsync fence;
+	int width;
+	int height;
+} FosterReadback_OpenGL;
+
 typedef struct
 {
 	// GL function pointers
@@ -516,10 +545,19 @@ GLenum FosterFilterToGL(FosterTextureFilter filter)
 	{
 		case FOSTER_TEXTURE_FILTER_NEAREST: return GL_NEAREST;
 		case FOSTER_TEXTURE_FILTER_LINEAR: return GL_LINEAR;
+		case FOSTER_TEXTURE_FILTER_TRILINEAR: return GL_LINEAR;
 		default: return GL_NEAREST;
 	}
 }
 
+GLenum FosterMinFilterToGL(FosterTextureFilter filter, int mipLevels)
+{
+	// textures without mips would be incomplete with a mipmap filter, so they fall back to linear
+	if (filter == FOSTER_TEXTURE_FILTER_TRILINEAR && mipLevels > 1)
+		return GL_LINEAR_MIPMAP_LINEAR;
+	return FosterFilterToGL(filter);
+}
+
 GLenum FosterBlendOpToGL(FosterBlendOp operation)
 {
 	switch (operation)
@@ -772,7 +810,7 @@ void FosterSetTextureSampler(FosterTexture_OpenGL* tex, FosterTextureSampler sam
 
 		if (tex->sampler.filter != sampler.filter)
 		{
-			fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, FosterFilterToGL(sampler.filter));
+			fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, FosterMinFilterToGL(sampler.filter, tex->mipLevels));
 			fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, FosterFilterToGL(sampler.filter));
 		}
 
@@ -1112,6 +1150,7 @@ FosterTexture* FosterTextureCreate_OpenGL(int width, int height, FosterTextureFo
 	result.glType = GL_UNSIGNED_BYTE;
 	result.refCount = 1;
 	result.disposed = 0;
+	result.mipLevels = 1;
 	result.sampler.filter = -1;
 	result.sampler.wrapX = -1;
 	result.sampler.wrapY = -1;
@@ -1153,6 +1192,7 @@ FosterTexture* FosterTextureCreate_OpenGL(int width, int height, FosterTextureFo
 
 	FosterBindTexture(0, result.id);
 	fgl.glTexImage2D(GL_TEXTURE_2D, 0, result.glInternalFormat, width, height, 0, result.glFormat, result.glType, NULL);
+	fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
 
 	tex = (FosterTexture_OpenGL*)SDL_malloc(sizeof(FosterTexture_OpenGL));
 	*tex = result;
@@ -1166,6 +1206,45 @@ void FosterTextureSetData_OpenGL(FosterTexture* texture, void* data, int length)
 	fgl.glTexImage2D(GL_TEXTURE_2D, 0, tex->glInternalFormat, tex->width, tex->height, 0, tex->glFormat, tex->glType, data);
 }
 
+void FosterTextureSetSubData_OpenGL(FosterTexture* texture, int x, int y, int width, int height, void* data, int length)
+{
+	FosterTexture_OpenGL* tex = (FosterTexture_OpenGL*)texture;
+	FosterBindTexture(0, tex->id);
+	fgl.glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, tex->glFormat, tex->glType, data);
+}
+
+void FosterTextureSetCoverage_OpenGL(FosterTexture* texture)
+{
+	FosterTexture_OpenGL* tex = (FosterTexture_OpenGL*)texture;
+
+	// coverage data (ex. font atlases) samples as premultiplied white (r, r, r, r),
+	// so it can be drawn by the same shaders as RGBA textures
+	FosterBindTexture(0, tex->id);
+	fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_RED);
+	fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+	fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+	fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED);
+}
+
+void FosterTextureSetMipData_OpenGL(FosterTexture* texture, int level, void* data, int length)
+{
+	FosterTexture_OpenGL* tex = (FosterTexture_OpenGL*)texture;
+	int width = SDL_max(1, tex->width >> level);
+	int height = SDL_max(1, tex->height >> level);
+
+	FosterBindTexture(0, tex->id);
+	fgl.glTexImage2D(GL_TEXTURE_2D, level, tex->glInternalFormat, width, height, 0, tex->glFormat, tex->glType, data);
+
+	if (level + 1 > tex->mipLevels)
+	{
+		tex->mipLevels = level + 1;
+		fgl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level);
+
+		// the min filter depends on whether there are mips, so make sure it's reapplied
+		tex->sampler.filter = -1;
+	}
+}
+
 void FosterTextureGetData_OpenGL(FosterTexture* texture, void* data, int length)
 {
 	FosterTexture_OpenGL* tex = (FosterTexture_OpenGL*)texture;
@@ -1265,6 +1344,104 @@ void FosterTargetDestroy_OpenGL(FosterTarget* target)
 	SDL_free(tar);
 }
 
+FosterReadback* FosterReadbackCreate_OpenGL(int width, int height)
+{
+	FosterReadback_OpenGL result;
+	FosterReadback_OpenGL* readback = NULL;
+
+	result.buffer = 0;
+	result.fence = NULL;
+	result.width = width;
+	result.height = height;
+
+	fgl.glGenBuffers(1, &result.buffer);
+	if (result.buffer == 0)
+	{
+		FOSTER_LOG_ERROR("Failed to create Readback");
+		return NULL;
+	}
+
+	fgl.glBindBuffer(GL_PIXEL_PACK_BUFFER, result.buffer);
+	fgl.glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, NULL, GL_STREAM_READ);
+	fgl.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	readback = (FosterReadback_OpenGL*)SDL_malloc(sizeof(FosterReadback_OpenGL));
+	*readback = result;
+	return (FosterReadback*)readback;
+}
+
+void FosterReadbackRequest_OpenGL(FosterReadback* readback, FosterTarget* target, int x, int y)
+{
+	FosterReadback_OpenGL* rb = (FosterReadback_OpenGL*)readback;
+	FosterTarget_OpenGL* tar = (FosterTarget_OpenGL*)target;
+
+	if (rb->fence != NULL)
+	{
+		fgl.glDeleteSync(rb->fence);
+		rb->fence = NULL;
+	}
+
+	// only the read framebuffer is changed, so the tracked draw framebuffer state stays valid
+	fgl.glBindFramebuffer(GL_READ_FRAMEBUFFER, tar == NULL ? 0 : tar->id);
+	fgl.glReadBuffer(tar == NULL ? GL_BACK : GL_COLOR_ATTACHMENT0);
+
+	// with a pack buffer bound, ReadPixels copies on the GPU and returns immediately
+	fgl.glBindBuffer(GL_PIXEL_PACK_BUFFER, rb->buffer);
+	fgl.glReadPixels(x, y, rb->width, rb->height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	fgl.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	fgl.glBindFramebuffer(GL_READ_FRAMEBUFFER, fgl.stateFrameBuffer);
+
+	// the fence is flushed so that it's guaranteed to eventually signal while polling
+	rb->fence = fgl.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	fgl.glFlush();
+}
+
+bool FosterReadbackReady_OpenGL(FosterReadback* readback)
+{
+	FosterReadback_OpenGL* rb = (FosterReadback_OpenGL*)readback;
+	if (rb->fence == NULL)
+		return false;
+
+	GLenum status = fgl.glClientWaitSync(rb->fence, 0, 0);
+	return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+bool FosterReadbackGetData_OpenGL(FosterReadback* readback, void* data, int length)
+{
+	FosterReadback_OpenGL* rb = (FosterReadback_OpenGL*)readback;
+	int size = rb->width * rb->height * 4;
+	bool result = false;
+
+	if (rb->fence == NULL)
+		return false;
+
+	// mapping waits for the copy if it hasn't finished yet
+	fgl.glBindBuffer(GL_PIXEL_PACK_BUFFER, rb->buffer);
+	void* mapped = fgl.glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+	if (mapped != NULL)
+	{
+		SDL_memcpy(data, mapped, SDL_min(size, length));
+		fgl.glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		result = true;
+	}
+	fgl.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	fgl.glDeleteSync(rb->fence);
+	rb->fence = NULL;
+	return result;
+}
+
+void FosterReadbackDestroy_OpenGL(FosterReadback* readback)
+{
+	FosterReadback_OpenGL* rb = (FosterReadback_OpenGL*)readback;
+
+	if (rb->fence != NULL)
+		fgl.glDeleteSync(rb->fence);
+
+	fgl.glDeleteBuffers(1, &rb->buffer);
+	SDL_free(rb);
+}
+
 FosterShader* FosterShaderCreate_OpenGL(FosterShaderData* data)
 {
 	GLchar log[1024] = { 0 };
@@ -1822,11 +1999,19 @@ bool FosterGetDevice_OpenGL(FosterRenderDevice* device)
 	device->frameEnd = FosterFrameEnd_OpenGL;
 	device->textureCreate = FosterTextureCreate_OpenGL;
 	device->textureSetData = FosterTextureSetData_OpenGL;
+	device->textureSetSubData = FosterTextureSetSubData_OpenGL;
+	device->textureSetMipData = FosterTextureSetMipData_OpenGL;
 	device->textureGetData = FosterTextureGetData_OpenGL;
+	device->textureSetCoverage = FosterTextureSetCoverage_OpenGL;
 	device->textureDestroy = FosterTextureDestroy_OpenGL;
 	device->targetCreate = FosterTargetCreate_OpenGL;
 	device->targetGetAttachment = FosterTargetGetAttachment_OpenGL;
 	device->targetDestroy = FosterTargetDestroy_OpenGL;
+	device->readbackCreate = FosterReadbackCreate_OpenGL;
+	device->readbackRequest = FosterReadbackRequest_OpenGL;
+	device->readbackReady = FosterReadbackReady_OpenGL;
+	device->readbackGetData = FosterReadbackGetData_OpenGL;
+	device->readbackDestroy = FosterReadbackDestroy_OpenGL;
 	device->shaderCreate = FosterShaderCreate_OpenGL;
 	device->shaderSetUniform = FosterShaderSetUniform_OpenGL;
 	device->shaderSetTexture = FosterShaderSetTexture_OpenGL;